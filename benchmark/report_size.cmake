@@ -0,0 +1,2 @@
+file(SIZE ${FILE} size)
+message(STATUS "compile_benchmark binary size: ${size} bytes")
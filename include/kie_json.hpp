@@ -4,9 +4,24 @@
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <concepts>
 #include <vector>
 #include <list>
+#include <deque>
 #include <array>
+#include <map>
+#include <unordered_map>
+#include <forward_list>
+#include <unordered_set>
+#include <shared_mutex>
+#include <mutex>
+#include <functional>
+#include <cstdint>
+#include <stdexcept>
+#include <optional>
+#include <thread>
+#include <exception>
+#include <algorithm>
 
 #include <iostream>
 
@@ -181,6 +196,165 @@ namespace kie::json
         }
     };
 
+
+    /** @brief A concurrent table which holds a single copy of each string.
+     * 
+     * The table is split into several shards, each protected by its own `std::shared_mutex`, so
+     * that threads decoding at the same time rarely wait for each other. A string is never removed
+     * once it's interned, so the views returned stay valid as long as the pool lives.
+     * 
+     * Usage:
+     * @code
+     * std::string_view s = InternPool::global().intern("hello");
+     * @endcode
+     */
+    class InternPool
+    {
+    public:
+        /** @brief Get the pool shared by the whole process.
+         * 
+         * This is the pool used by `from_json` for `InternedString`.
+         */
+        static InternPool &global()
+        {
+            static InternPool pool;
+            return pool;
+        }
+
+        /** @brief Find the pooled copy of a string, adding it if it doesn't exist.
+         * 
+         * Equal strings always get the same address, so they can be compared by pointer.
+         * 
+         * @param str The string to be interned.
+         * @return A view to the pooled copy. Empty string is not pooled and a default view is returned.
+         */
+        std::string_view intern(std::string_view str)
+        {
+            if (str.empty())
+            {
+                return {};
+            }
+            Shard &shard = shards[std::hash<std::string_view>{}(str) % shard_count];
+            {
+                std::shared_lock lock{shard.mutex};
+                if (auto it = shard.index.find(str); it != shard.index.end())
+                {
+                    return *it;
+                }
+            }
+            std::unique_lock lock{shard.mutex};
+            if (auto it = shard.index.find(str); it != shard.index.end())
+            {
+                return *it;
+            }
+            std::string_view pooled = shard.storage.emplace_front(str);
+            shard.index.insert(pooled);
+            return pooled;
+        }
+
+        /** @brief The number of distinct strings in the pool.
+         * 
+         */
+        std::size_t size() const
+        {
+            std::size_t n = 0;
+            for (const auto &shard : shards)
+            {
+                std::shared_lock lock{shard.mutex};
+                n += shard.index.size();
+            }
+            return n;
+        }
+
+    private:
+        static constexpr std::size_t shard_count = 16;
+
+        struct Shard
+        {
+            mutable std::shared_mutex mutex;
+            std::forward_list<std::string> storage; // nodes never move, so the views are stable
+            std::unordered_set<std::string_view> index;
+        };
+
+        std::array<Shard, shard_count> shards;
+    };
+
+
+    /** @brief A string stored in `InternPool`.
+     * 
+     * It's a compact handle for the string values that repeat a lot, like enum-like status or host names.
+     * When it's used as the type of a Field, `from_json` resolves the value against `InternPool::global()`
+     * instead of allocating a new `std::string` for every occurrence. Comparison is done by address first.
+     * 
+     * Usage:
+     * @code
+     * Field<InternedString, "status"> status;
+     * @endcode
+     */
+    class InternedString
+    {
+    public:
+        /** @brief The default constructor, which holds an empty string.
+         * 
+         */
+        InternedString() = default;
+
+        /** @brief Intern the string to the global pool.
+         * 
+         * @param str The string to be interned.
+         */
+        explicit InternedString(std::string_view str) : str(InternPool::global().intern(str))
+        {
+        }
+
+        /** @brief Intern the string to the specified pool.
+         * 
+         * @param str The string to be interned.
+         * @param pool The pool which holds the string.
+         */
+        InternedString(std::string_view str, InternPool &pool) : str(pool.intern(str))
+        {
+        }
+
+        /** @brief Get the view to the pooled string.
+         * 
+         * This function doesn't change anything in this class so it's marked as const.
+         */
+        [[nodiscard]] std::string_view view() const
+        {
+            return str;
+        }
+
+        /** @brief The implicit conversion function to `std::string_view`.
+         * 
+         */
+        operator std::string_view() const
+        {
+            return str;
+        }
+
+        /** @brief Compare two interned strings.
+         * 
+         * Equal strings in the same pool share the same address, so the content is only compared
+         * when the addresses differ, which happens for strings from different pools.
+         */
+        friend bool operator==(const InternedString &a, const InternedString &b)
+        {
+            return (a.str.data() == b.str.data() && a.str.size() == b.str.size()) || a.str == b.str;
+        }
+
+        /** @brief Compare an interned string with a normal string by content.
+         * 
+         */
+        friend bool operator==(const InternedString &a, std::string_view b)
+        {
+            return a.str == b;
+        }
+
+    private:
+        std::string_view str;
+    };
+
     /** @brief This namespace contains some trait used by this library at compile time.
      * 
      * It help robust this library with some compile time check with concept.
@@ -250,28 +424,41 @@ namespace kie::json
 
         /** @brief A concept checks if type T is a `container`.
          * 
-         * Container means three things here, a vector, a list and an array.
+         * Container means four things here, a vector, a list, a deque and an array.
          * 
          */
         template <typename T>
         concept is_container = is_specialization_of<T, std::vector>::value ||
             is_specialization_of<T, std::list>::value ||
+            is_specialization_of<T, std::deque>::value ||
             is_array_class<T>::value;
 
 
         /** @brief A concept checks if type T is a `dynamic container`
          * 
-         * Dynamic container means std::vector and std::list here.
+         * Dynamic container means std::vector, std::list and std::deque here.
          * 
          */
         template <typename T>
         concept is_dynamic_container = (is_specialization_of<T, std::vector>::value ||
-                                        is_specialization_of<T, std::list>::value) &&
+                                        is_specialization_of<T, std::list>::value ||
+                                        is_specialization_of<T, std::deque>::value) &&
                                        requires
         {
             typename T::value_type;
         };
 
+
+        /** @brief A concept checks if type T is a map with string key.
+         * 
+         * It means std::map and std::unordered_map here, which are converted to/from json object.
+         * 
+         */
+        template <typename T>
+        concept is_string_map = (is_specialization_of<T, std::map>::value ||
+                                 is_specialization_of<T, std::unordered_map>::value) &&
+                                std::is_same_v<typename T::key_type, std::string>;
+
         /** @brief Check if type T is a field.
          * 
          * With the limitation of `is_specialization_of`, this class is needed
@@ -293,15 +480,235 @@ namespace kie::json
         struct is_field<Field<T, str>> : std::true_type
         {
         };
+
+
+        /** @brief Get the tag of a field at compile time.
+         * 
+         * `Field::tag()` needs an instance, so this class helps when only the type is known.
+         * 
+         */
+        template <typename T>
+        struct field_tag
+        {
+        };
+
+
+        /** @brief Get the tag of a field at compile time.
+         * 
+         * `Field::tag()` needs an instance, so this class helps when only the type is known.
+         * 
+         */
+        template <typename T, StringLiteral str>
+        struct field_tag<Field<T, str>>
+        {
+            static constexpr std::string_view value = str.to_string_view();
+        };
+
+
+        /** @brief A concept checks if type T is a nested aggregate.
+         * 
+         * Nested aggregate means a class which is of aggregate type but not a container,
+         * which should be looped over field by field instead of being treated as a whole value.
+         * 
+         */
+        template <typename T>
+        concept is_nested_aggregate = std::is_aggregate_v<T> && std::is_class_v<T> && !is_container<T>;
+
+
+        /** @brief Check if type T can be compared with `operator==`.
+         * 
+         * `std::vector` and `std::list` always declare `operator==` even if their value type
+         * doesn't, so the value type of container is checked recursively.
+         * 
+         */
+        template <typename T>
+        struct is_deep_comparable : std::bool_constant<std::equality_comparable<T>>
+        {
+        };
+
+
+        /** @brief Check if type T can be compared with `operator==`.
+         * 
+         * This is the specialization for containers, which checks the value type.
+         * 
+         */
+        template <typename T>
+        requires is_container<T>
+        struct is_deep_comparable<T> : is_deep_comparable<typename T::value_type>
+        {
+        };
+
+
+        /** @brief Check if type T can be compared with `operator==`.
+         * 
+         * This is the specialization for maps, which checks the mapped type.
+         * 
+         */
+        template <typename T>
+        requires is_string_map<T>
+        struct is_deep_comparable<T> : is_deep_comparable<typename T::mapped_type>
+        {
+        };
+
+
+        /** @brief The number of Fields in an aggregate type T.
+         * 
+         * Members which are not wrapped with Field are not counted because they are
+         * never serialized.
+         * 
+         */
+        template <typename T>
+        constexpr std::size_t field_count = []<typename... Members>(std::type_identity<std::tuple<const Members &...>>)
+        {
+            return (std::size_t{0} + ... + (is_field<Members>::value ? 1 : 0));
+        }
+        (std::type_identity<decltype(boost::pfr::structure_tie(std::declval<const T &>()))>{});
+
+
+        /** @brief A concept checks if the object of a json type is stored in a flat vector.
+         * 
+         * For example, `nlohmann::ordered_json` stores key/value pairs contiguously. For such
+         * type, the capacity could be reserved before the fields are written.
+         * 
+         */
+        template <typename BasicJsonType>
+        concept has_flat_object = requires(typename BasicJsonType::object_t &o)
+        {
+            o.reserve(std::size_t{});
+        };
     }
 
+    /** @brief A json type whose objects are stored as contiguous key/value vectors.
+     * 
+     * Objects keep the declaration order of the fields instead of being sorted alphabetically, and
+     * small objects don't need a tree node for each key. `to_json` reserves the capacity with the number
+     * of fields, so one object needs only one allocation for its storage.
+     * 
+     * Usage:
+     * @code
+     * auto j = to_json<flat_json>(a);
+     * @endcode
+     */
+    using flat_json = nlohmann::ordered_json;
+
     /** @brief to_json overload that only accept container.
      * 
      * This is just a declaration for overload.
      * 
      */
-    template <type_trait::is_container T>
-    nlohmann::json to_json(const T &t);
+    template <typename BasicJsonType = nlohmann::json, type_trait::is_container T>
+    BasicJsonType to_json(const T &t);
+
+    /** @brief to_json overload that only accept map.
+     * 
+     * This is just a declaration for overload.
+     * 
+     */
+    template <typename BasicJsonType = nlohmann::json, type_trait::is_string_map T>
+    BasicJsonType to_json(const T &t);
+
+    namespace impl
+    {
+        /** @brief The layout of one Field in an aggregate type.
+         * 
+         */
+        struct FieldInfo
+        {
+            std::string_view tag;
+            std::size_t offset; // offset of `Field::value` from the start of the aggregate
+        };
+
+        /** @brief Get the layout of all the Fields in type T.
+         * 
+         * The fields are only looped over by pfr here, once for each T, and all the serde paths
+         * use the table instead. The offsets are the same for all the instances, so they are
+         * measured on the first instance passed in.
+         * 
+         * @param sample Any instance of T.
+         */
+        template <typename T>
+        const std::array<FieldInfo, type_trait::field_count<T>> &field_table(const T &sample)
+        {
+            static const std::array<FieldInfo, type_trait::field_count<T>> table = [&sample]
+            {
+                std::array<FieldInfo, type_trait::field_count<T>> infos{};
+                if constexpr (type_trait::field_count<T> > 0)
+                {
+                    const char *base = reinterpret_cast<const char *>(&sample);
+                    std::size_t index = 0;
+                    auto fill = [&infos, &index, base]<typename TT>(const TT &field)
+                    {
+                        if constexpr (type_trait::is_field<TT>::value)
+                        {
+                            infos[index++] = {
+                                type_trait::field_tag<TT>::value,
+                                static_cast<std::size_t>(reinterpret_cast<const char *>(&field.value) - base),
+                            };
+                        }
+                    };
+                    std::apply([&fill](const auto &...members)
+                               { (fill(members), ...); },
+                               boost::pfr::structure_tie(sample));
+                }
+                return infos;
+            }();
+            return table;
+        }
+
+        /** @brief Get the function of one serde path for a member of an aggregate type.
+         * 
+         * @return `Path::of<V>` if M is a Field whose type of value is V, otherwise nullptr.
+         */
+        template <typename Path, typename M>
+        constexpr typename Path::function field_function()
+        {
+            if constexpr (type_trait::is_field<M>::value)
+            {
+                return Path::template of<typename M::Type>;
+            }
+            else
+            {
+                return nullptr;
+            }
+        }
+
+        /** @brief The functions of one serde path for all the Fields in type T, in the order of `field_table`.
+         * 
+         * `Path::function` is the type of function and `Path::of<V>` is the one for the type of value V.
+         * The functions only depend on the type of value, so they are shared by all the aggregate types
+         * which have a Field of the same type, and only the paths in use are instantiated.
+         * 
+         */
+        template <typename T, typename Path>
+        constexpr std::array<typename Path::function, type_trait::field_count<T>> field_functions = []<typename... Members>(std::type_identity<std::tuple<const Members &...>>)
+        {
+            std::array<typename Path::function, type_trait::field_count<T>> functions{};
+            std::size_t k = 0;
+            ((type_trait::is_field<Members>::value ? void(functions[k++] = impl::field_function<Path, Members>()) : void()), ...);
+            return functions;
+        }
+        (std::type_identity<decltype(boost::pfr::structure_tie(std::declval<const T &>()))>{});
+
+        /** @brief The serde paths for `field_functions`.
+         * 
+         * These are declarations. Each one is defined next to the function it refers to.
+         * 
+         */
+        template <typename BasicJsonType>
+        struct FieldEncoder;
+        template <typename BasicJsonType>
+        struct FieldDecoder;
+        template <typename BasicJsonType>
+        struct CompactEncoder;
+        template <typename BasicJsonType>
+        struct CompactDecoder;
+        template <typename BasicJsonType>
+        struct PatchEncoder;
+        template <typename BasicJsonType>
+        struct FieldDiffer;
+        template <typename BasicJsonType>
+        struct FieldPatcher;
+    }
 
     /** @brief The version of to_json that accepts all the types
      * 
@@ -310,36 +717,46 @@ namespace kie::json
      * 
      * Notice that the input should be of aggregate type. Or a compile error
      * will occurs.
-     * 
-     */
-    template <typename T>
-    nlohmann::json to_json(const T &t)
-    {
-        nlohmann::json j;
-        boost::pfr::for_each_field(t, [&j]<typename TT>(const TT &field, std::size_t)
-                                   {
-            if constexpr(type_trait::is_field<TT>::value){
-                if constexpr(std::is_class_v<typename TT::Type> && !std::is_same_v<typename TT::Type, std::string>){
-                    j[std::string{field.tag()}] = to_json(field.value);
-                }else{
-                    j[std::string{field.tag()}] = field.value;
-                }
-            } });
-        return j;
-    }
-
-    /** @brief A specialization of to_json for std::string.
      * 
      * String is a special type for this library. It's a class, but should
      * not be treated as a class which will be looped over and std::string can
-     * be serialized or deserialized to/from json directly.
+     * be serialized or deserialized to/from json directly. So null is returned
+     * for string without wrapping with Field.
      * 
+     * @param BasicJsonType The json type to be generated, `nlohmann::json` by default.
      */
-    template <>
-    nlohmann::json to_json(const std::string &)
+    template <typename BasicJsonType = nlohmann::json, typename T>
+    BasicJsonType to_json(const T &t)
     {
-        nlohmann::json j;
-        return j; // return null for string without wrapping with Field
+        BasicJsonType j;
+        if constexpr (std::is_same_v<T, std::string>)
+        {
+            return j;
+        }
+        else if constexpr (std::is_same_v<T, InternedString>)
+        {
+            j = typename BasicJsonType::string_t{t.view()};
+            return j;
+        }
+        else
+        {
+            if constexpr (std::is_class_v<T>)
+            {
+                if constexpr (type_trait::has_flat_object<BasicJsonType> && type_trait::field_count<T> > 0)
+                {
+                    j = BasicJsonType::object();
+                    j.template get_ref<typename BasicJsonType::object_t &>().reserve(type_trait::field_count<T>);
+                }
+                const char *base = reinterpret_cast<const char *>(&t);
+                const auto &table = impl::field_table(t);
+                const auto &functions = impl::field_functions<T, impl::FieldEncoder<BasicJsonType>>;
+                for (std::size_t k = 0; k < table.size(); k++)
+                {
+                    functions[k](base + table[k].offset, j[std::string{table[k].tag}]);
+                }
+            }
+            return j;
+        }
     }
 
 
@@ -349,15 +766,20 @@ namespace kie::json
      * store the items if they are of Field type.
      * 
      */
-    template <type_trait::is_container T>
-    nlohmann::json to_json(const T &t)
+    template <typename BasicJsonType, type_trait::is_container T>
+    BasicJsonType to_json(const T &t)
     {
-        nlohmann::json j;
+        BasicJsonType j;
+        if (!t.empty())
+        {
+            j = BasicJsonType::array();
+            j.template get_ref<typename BasicJsonType::array_t &>().reserve(t.size());
+        }
         for (const auto &item : t)
         {
             if constexpr (std::is_class_v<std::decay_t<decltype(item)>> && !std::is_same_v<std::decay_t<decltype(item)>, std::string>)
             {
-                j.push_back(to_json(item));
+                j.push_back(to_json<BasicJsonType>(item));
             }
             else
             {
@@ -367,6 +789,38 @@ namespace kie::json
         return j;
     }
 
+    /** @brief to_json overload that only accept map.
+     * 
+     * This is the implementation version. The map is converted to json object
+     * with the same keys.
+     * 
+     */
+    template <typename BasicJsonType, type_trait::is_string_map T>
+    BasicJsonType to_json(const T &t)
+    {
+        BasicJsonType j;
+        if constexpr (type_trait::has_flat_object<BasicJsonType>)
+        {
+            if (!t.empty())
+            {
+                j = BasicJsonType::object();
+                j.template get_ref<typename BasicJsonType::object_t &>().reserve(t.size());
+            }
+        }
+        for (const auto &[key, value] : t)
+        {
+            if constexpr (std::is_class_v<typename T::mapped_type> && !std::is_same_v<typename T::mapped_type, std::string>)
+            {
+                j[key] = to_json<BasicJsonType>(value);
+            }
+            else
+            {
+                j[key] = value;
+            }
+        }
+        return j;
+    }
+
     /** @brief This namespace contains some function used internally.
      * 
      * They are all for some overload resolution.
@@ -376,61 +830,108 @@ namespace kie::json
     {
         /** @brief Convert nlohmann::json directly to T
          * 
-         * In this function, T should be the type which is supported by nlohmann_json
+         * In this function, T should be the type which is supported by nlohmann_json.
+         * All the overloads accept any specialization of `nlohmann::basic_json`.
          *
          * @param j The json object that contains only one thing.
          */
-        template <typename T>
-        T from_json(const nlohmann::json &j)
+        template <typename T, typename BasicJsonType>
+        T from_json(const BasicJsonType &j)
         {
             T t{};
             j.get_to(t);
             return t;
         }
 
+        /** @brief Convert json string to InternedString.
+         * 
+         * The string is resolved against `InternPool::global()`, so no new string is allocated if the
+         * value has been seen before. Null is converted to an empty string.
+         *
+         * @param j The json object that contains only one thing.
+         */
+        template <std::same_as<InternedString> T, typename BasicJsonType>
+        T from_json(const BasicJsonType &j)
+        {
+            if (j.is_null())
+            {
+                return {};
+            }
+            return T{j.template get_ref<const typename BasicJsonType::string_t &>()};
+        }
+
         /** @brief Convert json object to container.
          * 
          * This is a declaration.
          * 
          * @param j The json object that contains only one thing.
          */
-        template <type_trait::is_dynamic_container T>
-        T from_json(const nlohmann::json &j);
+        template <type_trait::is_dynamic_container T, typename BasicJsonType>
+        T from_json(const BasicJsonType &j);
 
-
-        /** @brief Convert json object to an aggregate type.
+        /** @brief Convert json object to map.
          * 
-         * Almost all the time, user should define a class that only contains Fields.
-         * And this is of aggregate type. An json object can be converted to it directly
-         * with the help of static reflection provided by pfr.
+         * This is a declaration.
          * 
          * @param j The json object that contains only one thing.
          */
-        template <typename T>
-        requires std::is_aggregate_v<T>
-            T from_json(const nlohmann::json &j)
+        template <type_trait::is_string_map T, typename BasicJsonType>
+        T from_json(const BasicJsonType &j);
+
+        /** @brief Convert json object to a value which is already in place.
+         * 
+         * This is a declaration.
+         * 
+         * @param j The json object that contains only one thing.
+         * @param t The value to be written, which must be just value-initialized.
+         */
+        template <typename T, typename BasicJsonType>
+        void from_json_to(const BasicJsonType &j, T &t);
+
+
+        /** @brief Convert json object to an aggregate type.
+         * 
+         * Almost all the time, user should define a class that only contains Fields.
+         * And this is of aggregate type. An json object can be converted to it directly
+         * with the help of static reflection provided by pfr.
+         * 
+         * @param j The json object that contains only one thing.
+         */
+        template <typename T, typename BasicJsonType>
+        requires type_trait::is_nested_aggregate<T>
+            T from_json(const BasicJsonType &j)
         {
             T t{};
-            boost::pfr::for_each_field(t, [&j]<typename TT>(TT &field, std::size_t)
-                                       {
-                if constexpr(type_trait::is_field<TT>::value){
-                    if constexpr(std::is_class_v<typename TT::Type> && !std::is_same_v<typename TT::Type, std::string>){
-                        field = impl::from_json<typename TT::Type>(j.at(std::string{field.tag()}));
-                    }else{
-                        j.at(std::string{field.tag()}).get_to(field.value);
-                    }
-                } });
+            impl::from_json_to(j, t);
+            return t;
+        }
+
+        /** @brief Convert json array to `std::array`.
+         * 
+         * The items are filled in place. Null is converted to a value-initialized array.
+         * 
+         * @param j The json object that contains only one thing.
+         * @throw std::runtime_error if the size of json array doesn't match.
+         */
+        template <typename T, typename BasicJsonType>
+        requires type_trait::is_array_class<T>::value
+            T from_json(const BasicJsonType &j)
+        {
+            T t{};
+            impl::from_json_to(j, t);
             return t;
         }
 
         /** @brief Convert json object to container.
          * 
          * Some json could be of array type, and this function handles such conversion.
+         * The capacity is reserved with the number of items up front, and each item is
+         * decoded directly in its slot.
          * 
          * @param j The json object that contains only one thing.
          */
-        template <type_trait::is_dynamic_container T>
-        T from_json(const nlohmann::json &j)
+        template <type_trait::is_dynamic_container T, typename BasicJsonType>
+        T from_json(const BasicJsonType &j)
         {
             if (!j.is_array())
             {
@@ -443,10 +944,155 @@ namespace kie::json
             }
             for (const auto &item : j)
             {
-                t.push_back(impl::from_json<std::decay_t<typename T::value_type>>(item));
+                if constexpr (std::is_same_v<typename T::value_type, bool>)
+                {
+                    t.push_back(impl::from_json<bool>(item)); // std::vector<bool> has no real reference to its slot
+                }
+                else
+                {
+                    impl::from_json_to(item, t.emplace_back());
+                }
             }
             return t;
         }
+
+        /** @brief Convert json object to map.
+         * 
+         * The buckets are reserved with the number of keys up front for `std::unordered_map`, and
+         * each value is decoded directly in its slot.
+         * 
+         * @param j The json object that contains only one thing.
+         */
+        template <type_trait::is_string_map T, typename BasicJsonType>
+        T from_json(const BasicJsonType &j)
+        {
+            if (!j.is_object())
+            {
+                return {};
+            }
+            T t;
+            if constexpr (type_trait::is_specialization_of<T, std::unordered_map>::value)
+            {
+                t.reserve(j.size());
+            }
+            for (auto it = j.begin(); it != j.end(); ++it)
+            {
+                impl::from_json_to(it.value(), t.try_emplace(t.end(), it.key())->second);
+            }
+            return t;
+        }
+
+        /** @brief Convert json object to a value which is already in place.
+         * 
+         * Aggregates and `std::array` are filled field by field or item by item, so no temporary
+         * is built and moved. Other types are assigned with the result of `from_json`.
+         * 
+         * @param j The json object that contains only one thing.
+         * @param t The value to be written, which must be just value-initialized.
+         */
+        template <typename T, typename BasicJsonType>
+        void from_json_to(const BasicJsonType &j, T &t)
+        {
+            if constexpr (type_trait::is_nested_aggregate<T>)
+            {
+                char *base = reinterpret_cast<char *>(&t);
+                const auto &table = impl::field_table(t);
+                const auto &functions = impl::field_functions<T, impl::FieldDecoder<BasicJsonType>>;
+                for (std::size_t k = 0; k < table.size(); k++)
+                {
+                    functions[k](base + table[k].offset, j.at(std::string{table[k].tag}));
+                }
+            }
+            else if constexpr (type_trait::is_array_class<T>::value)
+            {
+                if (j.is_null())
+                {
+                    return;
+                }
+                if (!j.is_array() || j.size() != t.size())
+                {
+                    throw std::runtime_error("kie_json: size of array mismatch");
+                }
+                std::size_t i = 0;
+                for (const auto &item : j)
+                {
+                    impl::from_json_to(item, t[i++]);
+                }
+            }
+            else
+            {
+                t = impl::from_json<T>(j);
+            }
+        }
+
+        /** @brief Write a value of a Field to json.
+         * 
+         * It's used by `FieldEncoder`, so only one instance exists for each type of value.
+         * 
+         * @param value The address of `Field::value`.
+         * @param j The json object to be written.
+         */
+        template <typename BasicJsonType, typename V>
+        void encode_field(const void *value, BasicJsonType &j)
+        {
+            const V &v = *static_cast<const V *>(value);
+            if constexpr (std::is_class_v<V> && !std::is_same_v<V, std::string>)
+            {
+                j = to_json<BasicJsonType>(v);
+            }
+            else
+            {
+                j = v;
+            }
+        }
+
+        /** @brief The path of `encode_field` for `field_functions`.
+         * 
+         */
+        template <typename BasicJsonType>
+        struct FieldEncoder
+        {
+            using function = void (*)(const void *value, BasicJsonType &j);
+            template <typename V>
+            static constexpr function of = &impl::encode_field<BasicJsonType, V>;
+        };
+
+        /** @brief Read a value of a Field from json.
+         * 
+         * It's used by `FieldDecoder`, so only one instance exists for each type of value.
+         * 
+         * @param value The address of `Field::value`.
+         * @param j The json object that contains only one thing.
+         */
+        template <typename BasicJsonType, typename V>
+        void decode_field(void *value, const BasicJsonType &j)
+        {
+            V &v = *static_cast<V *>(value);
+            if constexpr (type_trait::is_nested_aggregate<V> || type_trait::is_array_class<V>::value)
+            {
+                v = V{}; // the default member initializer of the Field may have changed it
+                impl::from_json_to(j, v);
+            }
+            else if constexpr (std::is_class_v<V> && !std::is_same_v<V, std::string>)
+            {
+                impl::from_json_to(j, v);
+            }
+            else
+            {
+                j.get_to(v);
+            }
+        }
+
+        /** @brief The path of `decode_field` for `field_functions`.
+         * 
+         */
+        template <typename BasicJsonType>
+        struct FieldDecoder
+        {
+            using function = void (*)(void *value, const BasicJsonType &j);
+            template <typename V>
+            static constexpr function of = &impl::decode_field<BasicJsonType, V>;
+        };
     }
 
     /** @brief Converting string_view to aggregate type.
@@ -454,53 +1100,937 @@ namespace kie::json
      * This is a friendly deserialization function for json.
      * 
      * @param json_str a json string.
+     * @param BasicJsonType The json type used for parsing, `nlohmann::json` by default.
      * 
      */
-    template <typename T>
+    template <typename T, typename BasicJsonType = nlohmann::json>
     requires std::is_aggregate_v<T> && std::is_class_v<T>
         T from_json(std::string_view json_str)
     {
-        nlohmann::json j = nlohmann::json::parse(json_str);
-        T t{};
-        boost::pfr::for_each_field(t, [&j]<typename TT>(TT &field, std::size_t)
-                                   {
-            if constexpr(type_trait::is_field<TT>::value){
-                if constexpr(std::is_class_v<typename TT::Type> && !std::is_same_v<typename TT::Type, std::string>){
-                    field = impl::from_json<typename TT::Type>(j.at(std::string{field.tag()}));
-                }else{
-                    j.at(std::string{field.tag()}).get_to(field.value);
-                }
-            } });
-        return t;
+        return impl::from_json<T>(BasicJsonType::parse(json_str));
     }
 
-    /** @brief Converting string_view to container type.
+    /** @brief Converting string_view to container or map type.
      * 
      * This is a friendly deserialization function for json.
      * 
      * @param json_str a json string.
+     * @param BasicJsonType The json type used for parsing, `nlohmann::json` by default.
      * 
      */
-    template <type_trait::is_dynamic_container T>
-    T from_json(std::string_view json_str)
+    template <typename T, typename BasicJsonType = nlohmann::json>
+    requires type_trait::is_dynamic_container<T> || type_trait::is_string_map<T>
+        T from_json(std::string_view json_str)
     {
-        nlohmann::json j = nlohmann::json::parse(json_str);
-        if (!j.is_array())
+        return impl::from_json<T>(BasicJsonType::parse(json_str));
+    }
+
+    namespace impl
+    {
+        /** @brief Check if a string only contains json whitespace.
+         * 
+         * @param str The string to be checked.
+         */
+        inline bool is_blank(std::string_view str)
         {
-            return {};
+            return str.find_first_not_of(" \t\n\r") == std::string_view::npos;
         }
-        T t;
-        if constexpr (type_trait::is_specialization_of<T, std::vector>::value)
+
+        /** @brief Find the ranges of the top level items of a json array.
+         * 
+         * It only tracks brackets and strings without parsing anything, so it's much faster than
+         * building the whole DOM. Each range is validated later when it's parsed.
+         * 
+         * @param json_str a json string.
+         * @return The ranges of the items, or nothing if json_str is not a well formed array.
+         */
+        inline std::optional<std::vector<std::string_view>> split_array(std::string_view json_str)
         {
-            t.reserve(j.size());
+            std::size_t pos = json_str.find_first_not_of(" \t\n\r");
+            if (pos == std::string_view::npos || json_str[pos] != '[')
+            {
+                return std::nullopt;
+            }
+            std::vector<std::string_view> items;
+            std::size_t start = pos + 1;
+            std::size_t depth = 0;
+            bool in_string = false;
+            for (std::size_t i = pos; i < json_str.size(); i++)
+            {
+                char c = json_str[i];
+                if (in_string)
+                {
+                    if (c == '\\')
+                    {
+                        i++;
+                    }
+                    else if (c == '"')
+                    {
+                        in_string = false;
+                    }
+                    continue;
+                }
+                switch (c)
+                {
+                case '"':
+                    in_string = true;
+                    break;
+                case '[':
+                case '{':
+                    depth++;
+                    break;
+                case ']':
+                case '}':
+                    if (--depth == 0)
+                    {
+                        std::string_view item = json_str.substr(start, i - start);
+                        if (c != ']' || !is_blank(json_str.substr(i + 1)) || (is_blank(item) && !items.empty()))
+                        {
+                            return std::nullopt;
+                        }
+                        if (!is_blank(item))
+                        {
+                            items.push_back(item);
+                        }
+                        return items;
+                    }
+                    break;
+                case ',':
+                    if (depth == 1)
+                    {
+                        std::string_view item = json_str.substr(start, i - start);
+                        if (is_blank(item))
+                        {
+                            return std::nullopt;
+                        }
+                        items.push_back(item);
+                        start = i + 1;
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+            return std::nullopt;
+        }
+    }
+
+    /** @brief Converting one large json array to `std::vector` with multiple threads.
+     * 
+     * The boundaries of the top level items are found by a fast scan first, then the items are
+     * parsed and converted in parallel into a pre-sized vector. Each item is converted just like
+     * `from_json` does. If the string is not an array, it falls back to `from_json`.
+     * 
+     * @param json_str a json string.
+     * @param threads The number of threads to be used, `std::thread::hardware_concurrency()` by default.
+     * @param BasicJsonType The json type used for parsing, `nlohmann::json` by default.
+     * @throw std::system_error if a thread can't be started, after the started ones are finished.
+     * 
+     */
+    template <typename T, typename BasicJsonType = nlohmann::json>
+    requires type_trait::is_specialization_of<T, std::vector>::value && (!std::is_same_v<typename T::value_type, bool>)
+        T from_json_parallel(std::string_view json_str, std::size_t threads = std::thread::hardware_concurrency())
+    {
+        auto items = impl::split_array(json_str);
+        if (!items)
+        {
+            return from_json<T, BasicJsonType>(json_str);
+        }
+        T t(items->size());
+        auto convert = [&t, &items](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; i++)
+            {
+                impl::from_json_to(BasicJsonType::parse((*items)[i]), t[i]);
+            }
+        };
+        threads = std::min(std::max<std::size_t>(threads, 1), items->size());
+        if (threads <= 1)
+        {
+            convert(0, items->size());
+            return t;
+        }
+        std::size_t chunk = (items->size() + threads - 1) / threads;
+        std::vector<std::exception_ptr> errors(threads);
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        try
+        {
+            for (std::size_t w = 0; w < threads; w++)
+            {
+                workers.emplace_back([&convert, &errors, &items, chunk, w]
+                                     {
+                    try{
+                        convert(std::min(w * chunk, items->size()), std::min((w + 1) * chunk, items->size()));
+                    }catch(...){
+                        errors[w] = std::current_exception();
+                    } });
+            }
+        }
+        catch (...)
+        {
+            // a joinable std::thread calls std::terminate when destroyed, so wait for the started ones
+            for (auto &worker : workers)
+            {
+                worker.join();
+            }
+            throw;
         }
-        for (const auto &item : j)
+        for (auto &worker : workers)
         {
-            t.push_back(impl::from_json<std::decay_t<typename T::value_type>>(item));
+            worker.join();
+        }
+        for (const auto &error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
         }
         return t;
     }
 
+    /** @brief Generate a JSON merge patch (RFC 7386) between two instances.
+     * 
+     * This is a declaration for recursion.
+     * 
+     */
+    template <typename BasicJsonType = nlohmann::json, typename T>
+    requires std::is_aggregate_v<T> && std::is_class_v<T>
+        BasicJsonType diff(const T &a, const T &b);
+
+    namespace impl
+    {
+        /** @brief Check if two values are equal.
+         * 
+         * If the type doesn't support `operator==`, the serialized json of both values are compared instead.
+         * 
+         */
+        template <typename T>
+        bool equal(const T &a, const T &b)
+        {
+            if constexpr (type_trait::is_deep_comparable<T>::value)
+            {
+                return a == b;
+            }
+            else
+            {
+                return to_json(a) == to_json(b);
+            }
+        }
+
+        /** @brief Apply a JSON merge patch to an aggregate type in place.
+         * 
+         * This is a declaration for recursion.
+         * 
+         */
+        template <typename T, typename BasicJsonType>
+        requires std::is_aggregate_v<T> && std::is_class_v<T>
+        void apply_patch(T &t, const BasicJsonType &patch);
+
+        /** @brief Convert a value to json which is written as a whole to a merge patch.
+         * 
+         * Unlike `to_json`, empty containers and maps are written as `[]` and `{}`, because null
+         * means deleting the key in a merge patch, and every Field of a nested aggregate is kept.
+         * 
+         * @param v The value to be written.
+         */
+        template <typename BasicJsonType, typename V>
+        BasicJsonType to_patch_value(const V &v)
+        {
+            if constexpr (type_trait::is_container<V>)
+            {
+                return v.empty() ? BasicJsonType::array() : to_json<BasicJsonType>(v);
+            }
+            else if constexpr (type_trait::is_string_map<V>)
+            {
+                BasicJsonType j = BasicJsonType::object();
+                for (const auto &[key, value] : v)
+                {
+                    j[key] = impl::to_patch_value<BasicJsonType>(value);
+                }
+                return j;
+            }
+            else if constexpr (type_trait::is_nested_aggregate<V>)
+            {
+                BasicJsonType j = BasicJsonType::object();
+                const char *base = reinterpret_cast<const char *>(&v);
+                const auto &table = impl::field_table(v);
+                const auto &functions = impl::field_functions<V, impl::PatchEncoder<BasicJsonType>>;
+                for (std::size_t k = 0; k < table.size(); k++)
+                {
+                    functions[k](base + table[k].offset, j[std::string{table[k].tag}]);
+                }
+                return j;
+            }
+            else if constexpr (std::is_class_v<V> && !std::is_same_v<V, std::string>)
+            {
+                return to_json<BasicJsonType>(v);
+            }
+            else
+            {
+                return BasicJsonType(v);
+            }
+        }
+
+        /** @brief Write the difference of one value to the patch.
+         * 
+         * Nested aggregates are compared field by field and string maps key by key, so only the
+         * changed part is written and the removed keys are written as null. Other types,
+         * including containers, are compared and written as a whole value.
+         * 
+         * @param a The old value.
+         * @param b The new value.
+         * @param patch The json object to write the difference to.
+         * @param key The key of the value in the patch.
+         */
+        template <typename BasicJsonType, typename V>
+        void diff_value(const V &a, const V &b, BasicJsonType &patch, std::string_view key)
+        {
+            if constexpr (type_trait::is_nested_aggregate<V>)
+            {
+                BasicJsonType sub = kie::json::diff<BasicJsonType>(a, b);
+                if (!sub.empty())
+                {
+                    patch[std::string{key}] = std::move(sub);
+                }
+            }
+            else if constexpr (type_trait::is_string_map<V>)
+            {
+                BasicJsonType sub = BasicJsonType::object();
+                for (const auto &[k, value] : a)
+                {
+                    if (!b.contains(k))
+                    {
+                        sub[k] = nullptr;
+                    }
+                }
+                for (const auto &[k, value] : b)
+                {
+                    auto it = a.find(k);
+                    if (it == a.end())
+                    {
+                        sub[k] = impl::to_patch_value<BasicJsonType>(value);
+                    }
+                    else
+                    {
+                        impl::diff_value(it->second, value, sub, k);
+                    }
+                }
+                if (!sub.empty())
+                {
+                    patch[std::string{key}] = std::move(sub);
+                }
+            }
+            else if (!impl::equal(a, b))
+            {
+                patch[std::string{key}] = impl::to_patch_value<BasicJsonType>(b);
+            }
+        }
+
+        /** @brief Apply a JSON merge patch to one value in place.
+         * 
+         * A null value resets it to its default value. An object value is merged into a nested
+         * aggregate or a string map, where null deletes the key. Otherwise the value is replaced.
+         * 
+         * @param v The value to be patched.
+         * @param j The part of merge patch for this value.
+         */
+        template <typename BasicJsonType, typename V>
+        void patch_value(V &v, const BasicJsonType &j)
+        {
+            if (j.is_null())
+            {
+                v = V{};
+            }
+            else if constexpr (type_trait::is_nested_aggregate<V>)
+            {
+                if (j.is_object())
+                {
+                    impl::apply_patch(v, j);
+                }
+                else
+                {
+                    v = impl::from_json<V>(j);
+                }
+            }
+            else if constexpr (type_trait::is_string_map<V>)
+            {
+                if (!j.is_object())
+                {
+                    v = impl::from_json<V>(j);
+                    return;
+                }
+                for (auto it = j.begin(); it != j.end(); ++it)
+                {
+                    if (it->is_null())
+                    {
+                        v.erase(it.key());
+                    }
+                    else
+                    {
+                        impl::patch_value(v[it.key()], it.value());
+                    }
+                }
+            }
+            else if constexpr (std::is_class_v<V> && !std::is_same_v<V, std::string>)
+            {
+                v = impl::from_json<V>(j);
+            }
+            else
+            {
+                j.get_to(v);
+            }
+        }
+
+        /** @brief Write a value of a Field to json as a whole for a merge patch.
+         * 
+         * It's used by `PatchEncoder`, so only one instance exists for each type of value.
+         * 
+         * @param value The address of `Field::value`.
+         * @param j The json object to be written.
+         */
+        template <typename BasicJsonType, typename V>
+        void encode_patch_field(const void *value, BasicJsonType &j)
+        {
+            j = impl::to_patch_value<BasicJsonType>(*static_cast<const V *>(value));
+        }
+
+        /** @brief The path of `encode_patch_field` for `field_functions`.
+         * 
+         */
+        template <typename BasicJsonType>
+        struct PatchEncoder
+        {
+            using function = void (*)(const void *value, BasicJsonType &j);
+            template <typename V>
+            static constexpr function of = &impl::encode_patch_field<BasicJsonType, V>;
+        };
+
+        /** @brief Write the difference of one Field to the patch.
+         * 
+         * It's used by `FieldDiffer`, so only one instance exists for each type of value.
+         * 
+         * @param a The address of the old `Field::value`.
+         * @param b The address of the new `Field::value`.
+         * @param patch The json object to write the difference to.
+         * @param tag The tag of the Field.
+         */
+        template <typename BasicJsonType, typename V>
+        void diff_field(const void *a, const void *b, BasicJsonType &patch, std::string_view tag)
+        {
+            impl::diff_value(*static_cast<const V *>(a), *static_cast<const V *>(b), patch, tag);
+        }
+
+        /** @brief The path of `diff_field` for `field_functions`.
+         * 
+         */
+        template <typename BasicJsonType>
+        struct FieldDiffer
+        {
+            using function = void (*)(const void *a, const void *b, BasicJsonType &patch, std::string_view tag);
+            template <typename V>
+            static constexpr function of = &impl::diff_field<BasicJsonType, V>;
+        };
+
+        /** @brief Apply a JSON merge patch to a value of a Field in place.
+         * 
+         * It's used by `FieldPatcher`, so only one instance exists for each type of value.
+         * 
+         * @param value The address of `Field::value`.
+         * @param j The part of merge patch for this Field.
+         */
+        template <typename BasicJsonType, typename V>
+        void patch_field(void *value, const BasicJsonType &j)
+        {
+            impl::patch_value(*static_cast<V *>(value), j);
+        }
+
+        /** @brief The path of `patch_field` for `field_functions`.
+         * 
+         */
+        template <typename BasicJsonType>
+        struct FieldPatcher
+        {
+            using function = void (*)(void *value, const BasicJsonType &j);
+            template <typename V>
+            static constexpr function of = &impl::patch_field<BasicJsonType, V>;
+        };
+
+        /** @brief Apply a JSON merge patch to an aggregate type in place.
+         * 
+         * Only the fields whose tag appears in the patch are touched, see `patch_value`.
+         * 
+         * @param t The instance to be patched.
+         * @param patch The json object of merge patch.
+         * @throw std::runtime_error if the patch is not an object, which would replace the whole aggregate.
+         */
+        template <typename T, typename BasicJsonType>
+        requires std::is_aggregate_v<T> && std::is_class_v<T>
+        void apply_patch(T &t, const BasicJsonType &patch)
+        {
+            if (!patch.is_object())
+            {
+                throw std::runtime_error("kie_json: merge patch of an aggregate must be an object");
+            }
+            char *base = reinterpret_cast<char *>(&t);
+            const auto &table = impl::field_table(t);
+            const auto &functions = impl::field_functions<T, impl::FieldPatcher<BasicJsonType>>;
+            for (std::size_t k = 0; k < table.size(); k++)
+            {
+                auto it = patch.find(std::string{table[k].tag});
+                if (it != patch.end())
+                {
+                    functions[k](base + table[k].offset, *it);
+                }
+            }
+        }
+    }
+
+    /** @brief Generate a JSON merge patch (RFC 7386) between two instances.
+     * 
+     * The fields are compared directly without serializing both instances, so the
+     * cost is in proportion to what changed. Nested aggregates and string maps are compared
+     * recursively, and containers are treated as whole values.
+     * 
+     * @param a The old instance.
+     * @param b The new instance.
+     * @return A json object which turns `a` into `b` when applied. It's empty if nothing changed.
+     */
+    template <typename BasicJsonType, typename T>
+    requires std::is_aggregate_v<T> && std::is_class_v<T>
+        BasicJsonType diff(const T &a, const T &b)
+    {
+        BasicJsonType patch = BasicJsonType::object();
+        const char *base_a = reinterpret_cast<const char *>(&a);
+        const char *base_b = reinterpret_cast<const char *>(&b);
+        const auto &table = impl::field_table(a);
+        const auto &functions = impl::field_functions<T, impl::FieldDiffer<BasicJsonType>>;
+        for (std::size_t k = 0; k < table.size(); k++)
+        {
+            functions[k](base_a + table[k].offset, base_b + table[k].offset, patch, table[k].tag);
+        }
+        return patch;
+    }
+
+    /** @brief Apply a JSON merge patch (RFC 7386) to an aggregate type in place.
+     * 
+     * This is a friendly function for the patch generated by `diff`.
+     * 
+     * @param t The instance to be patched.
+     * @param patch_str a json string of merge patch.
+     * @param BasicJsonType The json type used for parsing, `nlohmann::json` by default.
+     * @throw std::runtime_error if the patch is not a json object.
+     * 
+     */
+    template <typename BasicJsonType = nlohmann::json, typename T>
+    requires std::is_aggregate_v<T> && std::is_class_v<T>
+    void apply_patch(T &t, std::string_view patch_str)
+    {
+        impl::apply_patch(t, BasicJsonType::parse(patch_str));
+    }
+
+    namespace impl
+    {
+        /** @brief FNV-1a hash which can be evaluated at compile time.
+         * 
+         * @param str The string to be hashed.
+         * @param h The hash to be continued.
+         */
+        constexpr std::uint32_t fnv1a(std::string_view str, std::uint32_t h = 2166136261u)
+        {
+            for (char c : str)
+            {
+                h ^= static_cast<unsigned char>(c);
+                h *= 16777619u;
+            }
+            return h;
+        }
+
+        template <typename T, typename... Visited>
+        constexpr std::uint32_t schema_hash(std::uint32_t h);
+
+        /** @brief Continue the schema hash with one field.
+         * 
+         * Members which are not wrapped with Field don't change the hash.
+         * 
+         */
+        template <typename TT, typename... Visited>
+        constexpr std::uint32_t schema_field_hash(std::uint32_t h)
+        {
+            if constexpr (type_trait::is_field<TT>::value)
+            {
+                return impl::schema_hash<typename TT::Type, Visited...>(impl::fnv1a(type_trait::field_tag<TT>::value, h));
+            }
+            else
+            {
+                return h;
+            }
+        }
+
+        /** @brief Continue the schema hash with type T.
+         * 
+         * The tags and the kind of value of all the Fields are hashed in declaration order, recursing
+         * into nested aggregates and the value type of containers.
+         * 
+         * @param Visited The enclosing aggregates, outermost first. A recursive type is hashed as a
+         * reference back to the position of its first occurrence instead of being expanded again.
+         */
+        template <typename T, typename... Visited>
+        constexpr std::uint32_t schema_hash(std::uint32_t h)
+        {
+            if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, InternedString>)
+            {
+                return impl::fnv1a("s", h);
+            }
+            else if constexpr (type_trait::is_container<T>)
+            {
+                return impl::schema_hash<typename T::value_type, Visited...>(impl::fnv1a("[", h));
+            }
+            else if constexpr (type_trait::is_string_map<T>)
+            {
+                return impl::schema_hash<typename T::mapped_type, Visited...>(impl::fnv1a("m", h));
+            }
+            else if constexpr ((std::is_same_v<T, Visited> || ...))
+            {
+                std::uint32_t index = 0; // the position of T in Visited
+                ((std::is_same_v<T, Visited> ? false : (++index, true)) && ...);
+                return (impl::fnv1a("^", h) ^ index) * 16777619u;
+            }
+            else if constexpr (type_trait::is_nested_aggregate<T>)
+            {
+                h = impl::fnv1a("{", h);
+                [&h]<std::size_t... I>(std::index_sequence<I...>)
+                {
+                    ((h = impl::schema_field_hash<boost::pfr::tuple_element_t<I, T>, Visited..., T>(h)), ...);
+                }
+                (std::make_index_sequence<boost::pfr::tuple_size_v<T>>{});
+                return impl::fnv1a("}", h);
+            }
+            else if constexpr (std::is_same_v<T, bool>)
+            {
+                return impl::fnv1a("b", h);
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                return impl::fnv1a("i", h);
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                return impl::fnv1a("f", h);
+            }
+            else
+            {
+                return impl::fnv1a("?", h);
+            }
+        }
+    }
+
+    /** @brief The fingerprint of the schema of type T.
+     * 
+     * It's used by the compact encoding to detect that both sides don't share the same struct definition.
+     * 
+     */
+    template <typename T>
+    constexpr std::uint32_t schema_fingerprint = impl::schema_hash<T>(impl::fnv1a(""));
+
+    namespace impl
+    {
+        /** @brief Convert a value to the compact encoding.
+         * 
+         * Aggregates become arrays of the values of their Fields in declaration order, so no tag is written.
+         * Containers become arrays of their items.
+         * 
+         * @param t The value to be converted.
+         */
+        template <typename BasicJsonType, typename T>
+        BasicJsonType to_compact_json(const T &t)
+        {
+            if constexpr (std::is_same_v<T, InternedString>)
+            {
+                return typename BasicJsonType::string_t{t.view()};
+            }
+            else if constexpr (type_trait::is_container<T>)
+            {
+                BasicJsonType j = BasicJsonType::array();
+                for (const auto &item : t)
+                {
+                    j.push_back(impl::to_compact_json<BasicJsonType>(item));
+                }
+                return j;
+            }
+            else if constexpr (type_trait::is_string_map<T>)
+            {
+                BasicJsonType j = BasicJsonType::object();
+                for (const auto &[key, value] : t)
+                {
+                    j[key] = impl::to_compact_json<BasicJsonType>(value);
+                }
+                return j;
+            }
+            else if constexpr (type_trait::is_nested_aggregate<T>)
+            {
+                BasicJsonType j = BasicJsonType::array();
+                j.template get_ref<typename BasicJsonType::array_t &>().reserve(type_trait::field_count<T>);
+                const char *base = reinterpret_cast<const char *>(&t);
+                const auto &table = impl::field_table(t);
+                const auto &functions = impl::field_functions<T, impl::CompactEncoder<BasicJsonType>>;
+                for (std::size_t k = 0; k < table.size(); k++)
+                {
+                    functions[k](base + table[k].offset, j[k]);
+                }
+                return j;
+            }
+            else
+            {
+                return t;
+            }
+        }
+
+        /** @brief Convert the compact encoding to a value.
+         * 
+         * This is the reverse of `to_compact_json`. Types without aggregate inside are handled by `from_json`.
+         * 
+         * The fingerprint only covers the schema, not the data, so an aggregate whose array has extra or
+         * missing items is rejected here rather than silently dropping or defaulting them.
+         * 
+         * @param j The json object that contains only one thing.
+         * @throw std::runtime_error if the size of an array doesn't match.
+         */
+        template <typename T, typename BasicJsonType>
+        T from_compact_json(const BasicJsonType &j)
+        {
+            if constexpr (type_trait::is_dynamic_container<T>)
+            {
+                if (!j.is_array())
+                {
+                    return {};
+                }
+                T t;
+                if constexpr (type_trait::is_specialization_of<T, std::vector>::value)
+                {
+                    t.reserve(j.size());
+                }
+                for (const auto &item : j)
+                {
+                    t.push_back(impl::from_compact_json<std::decay_t<typename T::value_type>>(item));
+                }
+                return t;
+            }
+            else if constexpr (type_trait::is_array_class<T>::value)
+            {
+                T t{};
+                if (j.is_null())
+                {
+                    return t;
+                }
+                if (!j.is_array() || j.size() != t.size())
+                {
+                    throw std::runtime_error("kie_json: size of array mismatch");
+                }
+                for (std::size_t i = 0; i < t.size(); i++)
+                {
+                    t[i] = impl::from_compact_json<typename T::value_type>(j[i]);
+                }
+                return t;
+            }
+            else if constexpr (type_trait::is_string_map<T>)
+            {
+                T t;
+                if (!j.is_object())
+                {
+                    return t;
+                }
+                for (auto it = j.begin(); it != j.end(); ++it)
+                {
+                    t.try_emplace(t.end(), it.key(), impl::from_compact_json<typename T::mapped_type>(it.value()));
+                }
+                return t;
+            }
+            else if constexpr (type_trait::is_nested_aggregate<T>)
+            {
+                if (!j.is_array() || j.size() != type_trait::field_count<T>)
+                {
+                    throw std::runtime_error("kie_json: number of fields mismatch");
+                }
+                T t{};
+                char *base = reinterpret_cast<char *>(&t);
+                const auto &table = impl::field_table(t);
+                const auto &functions = impl::field_functions<T, impl::CompactDecoder<BasicJsonType>>;
+                for (std::size_t k = 0; k < table.size(); k++)
+                {
+                    functions[k](base + table[k].offset, j[k]);
+                }
+                return t;
+            }
+            else
+            {
+                return impl::from_json<T>(j);
+            }
+        }
+
+        /** @brief Write a value of a Field to the compact encoding.
+         * 
+         * It's used by `CompactEncoder`, so only one instance exists for each type of value.
+         * 
+         * @param value The address of `Field::value`.
+         * @param j The json object to be written.
+         */
+        template <typename BasicJsonType, typename V>
+        void encode_compact_field(const void *value, BasicJsonType &j)
+        {
+            j = impl::to_compact_json<BasicJsonType>(*static_cast<const V *>(value));
+        }
+
+        /** @brief The path of `encode_compact_field` for `field_functions`.
+         * 
+         */
+        template <typename BasicJsonType>
+        struct CompactEncoder
+        {
+            using function = void (*)(const void *value, BasicJsonType &j);
+            template <typename V>
+            static constexpr function of = &impl::encode_compact_field<BasicJsonType, V>;
+        };
+
+        /** @brief Read a value of a Field from the compact encoding.
+         * 
+         * It's used by `CompactDecoder`, so only one instance exists for each type of value.
+         * 
+         * @param value The address of `Field::value`.
+         * @param j The json object that contains only one thing.
+         */
+        template <typename BasicJsonType, typename V>
+        void decode_compact_field(void *value, const BasicJsonType &j)
+        {
+            *static_cast<V *>(value) = impl::from_compact_json<V>(j);
+        }
+
+        /** @brief The path of `decode_compact_field` for `field_functions`.
+         * 
+         */
+        template <typename BasicJsonType>
+        struct CompactDecoder
+        {
+            using function = void (*)(void *value, const BasicJsonType &j);
+            template <typename V>
+            static constexpr function of = &impl::decode_compact_field<BasicJsonType, V>;
+        };
+
+        /** @brief Check the fingerprint at the head of the compact encoding.
+         * 
+         * @param j The json array generated by `to_compact_json`.
+         * @throw std::runtime_error if the fingerprint doesn't match `schema_fingerprint<T>`.
+         */
+        template <typename T, typename BasicJsonType>
+        void check_fingerprint(const BasicJsonType &j)
+        {
+            if (!j.is_array() || j.empty() || !j.front().is_number_unsigned() || j.front().template get<std::uint32_t>() != schema_fingerprint<T>)
+            {
+                throw std::runtime_error("kie_json: schema fingerprint mismatch");
+            }
+        }
+    }
+
+    /** @brief Serialize an aggregate type with the compact encoding.
+     * 
+     * The result is a json array whose first item is `schema_fingerprint<T>` and the rest are the values
+     * of the Fields in declaration order. Fields are identified by their position instead of their tags, so
+     * it's much smaller than `to_json` when both sides share the same struct definition.
+     * 
+     * @param t The instance to be serialized.
+     * @param BasicJsonType The json type to be generated, `nlohmann::json` by default.
+     */
+    template <typename BasicJsonType = nlohmann::json, typename T>
+    requires type_trait::is_nested_aggregate<T>
+        BasicJsonType to_compact_json(const T &t)
+    {
+        BasicJsonType j = BasicJsonType::array();
+        j.template get_ref<typename BasicJsonType::array_t &>().reserve(type_trait::field_count<T> + 1);
+        j.push_back(schema_fingerprint<T>);
+        const char *base = reinterpret_cast<const char *>(&t);
+        const auto &table = impl::field_table(t);
+        const auto &functions = impl::field_functions<T, impl::CompactEncoder<BasicJsonType>>;
+        for (std::size_t k = 0; k < table.size(); k++)
+        {
+            functions[k](base + table[k].offset, j[k + 1]);
+        }
+        return j;
+    }
+
+    /** @brief Deserialize an aggregate type from the compact encoding.
+     * 
+     * This is the reverse of `to_compact_json`.
+     * 
+     * @param json_str a json string generated by `to_compact_json`.
+     * @param BasicJsonType The json type used for parsing, `nlohmann::json` by default.
+     * @throw std::runtime_error if the fingerprint doesn't match `schema_fingerprint<T>`, or the number
+     * of items of T or any nested aggregate doesn't match its number of Fields.
+     */
+    template <typename T, typename BasicJsonType = nlohmann::json>
+    requires type_trait::is_nested_aggregate<T>
+        T from_compact_json(std::string_view json_str)
+    {
+        BasicJsonType j = BasicJsonType::parse(json_str);
+        impl::check_fingerprint<T>(j);
+        if (j.size() != type_trait::field_count<T> + 1)
+        {
+            throw std::runtime_error("kie_json: number of fields mismatch");
+        }
+        T t{};
+        char *base = reinterpret_cast<char *>(&t);
+        const auto &table = impl::field_table(t);
+        const auto &functions = impl::field_functions<T, impl::CompactDecoder<BasicJsonType>>;
+        for (std::size_t k = 0; k < table.size(); k++)
+        {
+            functions[k](base + table[k].offset, j[k + 1]);
+        }
+        return t;
+    }
+
+    /** @brief Serialize a container of values with the compact encoding.
+     * 
+     * The result is a json array of two items: `schema_fingerprint<T>` and the compact encoding of the
+     * container. The fingerprint is written only once, so a batch of aggregates such as `std::vector<A>`
+     * costs no more than its items.
+     * 
+     * @param t The container or string map to be serialized.
+     * @param BasicJsonType The json type to be generated, `nlohmann::json` by default.
+     */
+    template <typename BasicJsonType = nlohmann::json, typename T>
+    requires type_trait::is_container<T> || type_trait::is_string_map<T>
+    BasicJsonType to_compact_json(const T &t)
+    {
+        BasicJsonType j = BasicJsonType::array();
+        j.template get_ref<typename BasicJsonType::array_t &>().reserve(2);
+        j.push_back(schema_fingerprint<T>);
+        j.push_back(impl::to_compact_json<BasicJsonType>(t));
+        return j;
+    }
+
+    /** @brief Deserialize a container of values from the compact encoding.
+     * 
+     * This is the reverse of `to_compact_json`.
+     * 
+     * @param json_str a json string generated by `to_compact_json`.
+     * @param BasicJsonType The json type used for parsing, `nlohmann::json` by default.
+     * @throw std::runtime_error if the fingerprint doesn't match `schema_fingerprint<T>`, the json array
+     * doesn't have exactly two items, or the number of items of any aggregate doesn't match its number
+     * of Fields.
+     */
+    template <typename T, typename BasicJsonType = nlohmann::json>
+    requires type_trait::is_container<T> || type_trait::is_string_map<T>
+    T from_compact_json(std::string_view json_str)
+    {
+        BasicJsonType j = BasicJsonType::parse(json_str);
+        impl::check_fingerprint<T>(j);
+        if (j.size() != 2)
+        {
+            throw std::runtime_error("kie_json: number of items mismatch");
+        }
+        return impl::from_compact_json<T>(j[1]);
+    }
+
 } // namespace kie::json
 
 #endif
\ No newline at end of file
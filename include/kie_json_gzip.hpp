@@ -0,0 +1,423 @@
+#ifndef KIE_JSON_KIE_JSON_GZIP_H
+#define KIE_JSON_KIE_JSON_GZIP_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+
+#include <zlib.h>
+
+#include <kie_json.hpp>
+
+namespace kie::json
+{
+
+    /** @brief The layout of records in a file read by `GzipReader`.
+     *
+     */
+    enum class GzipFormat
+    {
+        Auto,  // `Lines` for `.ndjson`/`.jsonl` files, otherwise decided by the first character
+        Array, // the items of the top level array are the records
+        Lines, // each line is a record, which may be an array itself
+    };
+
+    /** @brief Read records from a gzip compressed json or NDJSON file.
+     *
+     * The file is decompressed on a background thread into a ring of fixed buffers, while the
+     * thread calling `next` decodes records from the buffers which are already filled. So
+     * decompression and parsing overlap, and the memory is bounded by the size of the ring.
+     *
+     * The layout of records is given by `GzipFormat`. With `GzipFormat::Auto`, files named `.ndjson` or
+     * `.jsonl` (optionally followed by `.gz`) have one record per line. For other files, the items of the top
+     * level array are the records if the file starts with `[`, otherwise each line is a record. Plain
+     * files are also accepted because zlib reads them transparently.
+     *
+     * Usage:
+     * @code
+     * GzipReader<A> reader{"events.ndjson.gz"};
+     * A a;
+     * while(reader.next(a)){
+     *     // do something with a
+     * }
+     * @endcode
+     *
+     * @param T The type of each record.
+     * @param BasicJsonType The json type used for parsing, `nlohmann::json` by default.
+     */
+    template <typename T, typename BasicJsonType = nlohmann::json>
+    class GzipReader
+    {
+    public:
+        /** @brief Open the file and start decompressing it in background.
+         *
+         * @param path The path of the file.
+         * @param format The layout of records in the file.
+         * @param buffer_size The size of each buffer in the ring.
+         * @param buffer_count The number of buffers in the ring. At least two are needed for the overlap.
+         * @throw std::runtime_error if the file can't be opened.
+         */
+        explicit GzipReader(const std::string &path, GzipFormat format = GzipFormat::Auto, std::size_t buffer_size = 1 << 20, std::size_t buffer_count = 4)
+            : buffers(std::max<std::size_t>(buffer_count, 2), std::vector<char>(std::max<std::size_t>(buffer_size, 1))), format(format)
+        {
+            if (format == GzipFormat::Auto)
+            {
+                for (std::string_view ext : {".ndjson", ".ndjson.gz", ".jsonl", ".jsonl.gz"})
+                {
+                    if (std::string_view{path}.ends_with(ext))
+                    {
+                        this->format = GzipFormat::Lines;
+                    }
+                }
+            }
+            if (this->format == GzipFormat::Lines)
+            {
+                mode = Mode::Lines;
+            }
+            file = gzopen(path.c_str(), "rb");
+            if (file == nullptr)
+            {
+                throw std::runtime_error("kie_json: failed to open " + path);
+            }
+            gzbuffer(file, static_cast<unsigned>(std::min<std::size_t>(buffers.front().size(), 1 << 20)));
+            sizes.resize(buffers.size());
+            for (std::size_t i = 0; i < buffers.size(); i++)
+            {
+                free_buffers.push_back(i);
+            }
+            producer = std::thread{[this]
+                                   { decompress(); }};
+        }
+
+        GzipReader(const GzipReader &) = delete;
+        GzipReader &operator=(const GzipReader &) = delete;
+
+        /** @brief Stop decompressing and close the file.
+         *
+         */
+        ~GzipReader()
+        {
+            {
+                std::lock_guard lock{mutex};
+                stopped = true;
+            }
+            cv.notify_all();
+            producer.join();
+            gzclose(file);
+        }
+
+        /** @brief Decode the next record.
+         *
+         * @param t The record to be written.
+         * @return false if there is no more record.
+         * @throw std::runtime_error if the decompression fails, or the exception thrown by parsing.
+         */
+        bool next(T &t)
+        {
+            while (true)
+            {
+                if (current == npos && !acquire())
+                {
+                    return finish(t);
+                }
+                const char *data = buffers[current].data();
+                std::size_t size = sizes[current];
+                while (pos < size)
+                {
+                    std::size_t i = pos++;
+                    if (scan(data[i]))
+                    {
+                        std::string_view record = take(data, i);
+                        start = pos;
+                        if (!impl::is_blank(record))
+                        {
+                            t = impl::from_json<T>(BasicJsonType::parse(record));
+                            return true;
+                        }
+                    }
+                }
+                pending.append(data + start, size - start);
+                release();
+            }
+        }
+
+    private:
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        enum class Mode
+        {
+            Unknown,
+            Lines,
+            Array,
+            Done,
+        };
+
+        /** @brief The body of the background thread.
+         *
+         * It takes a free buffer, fills it with decompressed data and hands it to the consumer.
+         */
+        void decompress()
+        {
+            while (true)
+            {
+                std::size_t index;
+                {
+                    std::unique_lock lock{mutex};
+                    cv.wait(lock, [this]
+                            { return stopped || !free_buffers.empty(); });
+                    if (stopped)
+                    {
+                        return;
+                    }
+                    index = free_buffers.front();
+                    free_buffers.pop_front();
+                }
+                int n = gzread(file, buffers[index].data(), static_cast<unsigned>(buffers[index].size()));
+                std::lock_guard lock{mutex};
+                if (n <= 0)
+                {
+                    // a truncated stream also ends with 0, and the reason is only reported by gzerror
+                    int code = Z_OK;
+                    const char *message = gzerror(file, &code);
+                    if (code != Z_OK)
+                    {
+                        error = std::make_exception_ptr(std::runtime_error(std::string{"kie_json: "} + message));
+                    }
+                    eof = true;
+                    cv.notify_all();
+                    return;
+                }
+                sizes[index] = static_cast<std::size_t>(n);
+                filled_buffers.push_back(index);
+                cv.notify_all();
+            }
+        }
+
+        /** @brief Wait for the next filled buffer.
+         *
+         * @return false if the whole file has been consumed.
+         */
+        bool acquire()
+        {
+            std::unique_lock lock{mutex};
+            cv.wait(lock, [this]
+                    { return eof || !filled_buffers.empty(); });
+            if (filled_buffers.empty())
+            {
+                if (error)
+                {
+                    std::rethrow_exception(error);
+                }
+                return false;
+            }
+            current = filled_buffers.front();
+            filled_buffers.pop_front();
+            pos = 0;
+            start = 0;
+            return true;
+        }
+
+        /** @brief Give the current buffer back to the background thread.
+         *
+         */
+        void release()
+        {
+            {
+                std::lock_guard lock{mutex};
+                free_buffers.push_back(current);
+            }
+            cv.notify_all();
+            current = npos;
+        }
+
+        /** @brief Feed one character to the splitter.
+         *
+         * Only brackets and strings are tracked, just like `impl::split_array`.
+         *
+         * @param c The next character.
+         * @return true if c ends a record. c itself is not a part of the record.
+         * @throw std::runtime_error if there is anything but whitespace after the top level array,
+         * or `GzipFormat::Array` is required but the file doesn't start with `[`.
+         */
+        bool scan(char c)
+        {
+            if (in_string)
+            {
+                if (escaped)
+                {
+                    escaped = false;
+                }
+                else if (c == '\\')
+                {
+                    escaped = true;
+                }
+                else if (c == '"')
+                {
+                    in_string = false;
+                }
+                return false;
+            }
+            switch (mode)
+            {
+            case Mode::Done:
+                if (!is_space(c))
+                {
+                    throw std::runtime_error("kie_json: unexpected data after the top level array");
+                }
+                return false;
+            case Mode::Unknown:
+                if (is_space(c))
+                {
+                    return false;
+                }
+                if (c == '[')
+                {
+                    mode = Mode::Array;
+                    depth = 1;
+                    return true; // drop the bracket of the top level array
+                }
+                if (format == GzipFormat::Array)
+                {
+                    throw std::runtime_error("kie_json: expected a top level array");
+                }
+                mode = Mode::Lines;
+                break;
+            default:
+                break;
+            }
+            switch (c)
+            {
+            case '"':
+                in_string = true;
+                return false;
+            case '[':
+            case '{':
+                depth++;
+                return false;
+            case ']':
+            case '}':
+                if (depth == 0)
+                {
+                    return false; // unbalanced, left to the parser to report
+                }
+                depth--;
+                if (mode == Mode::Array && depth == 0)
+                {
+                    mode = Mode::Done;
+                    return true;
+                }
+                return false;
+            case ',':
+                return mode == Mode::Array && depth == 1;
+            case '\n':
+                return mode == Mode::Lines && depth == 0;
+            default:
+                return false;
+            }
+        }
+
+        /** @brief Check if c is json whitespace.
+         *
+         */
+        static bool is_space(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+        }
+
+        /** @brief Get the record which ends right before `data[end]`.
+         *
+         * If the record started in a previous buffer, it's joined into `pending`.
+         */
+        std::string_view take(const char *data, std::size_t end)
+        {
+            if (pending.empty())
+            {
+                return {data + start, end - start};
+            }
+            pending.append(data + start, end - start);
+            record.swap(pending);
+            pending.clear();
+            return record;
+        }
+
+        /** @brief Decode the record left at the end of the file.
+         *
+         * The last line of NDJSON may have no trailing newline.
+         *
+         * @throw std::runtime_error if the top level array is not closed or the last record is not terminated.
+         */
+        bool finish(T &t)
+        {
+            if (mode == Mode::Array)
+            {
+                throw std::runtime_error("kie_json: the top level array is not closed");
+            }
+            if (in_string || depth != 0)
+            {
+                throw std::runtime_error("kie_json: the last record is not terminated");
+            }
+            if (mode != Mode::Lines || impl::is_blank(pending))
+            {
+                return false;
+            }
+            record.swap(pending);
+            pending.clear();
+            t = impl::from_json<T>(BasicJsonType::parse(record));
+            return true;
+        }
+
+        gzFile file = nullptr;
+        std::vector<std::vector<char>> buffers;
+        GzipFormat format;
+        std::vector<std::size_t> sizes;
+        std::deque<std::size_t> free_buffers;
+        std::deque<std::size_t> filled_buffers;
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool stopped = false;
+        bool eof = false;
+        std::exception_ptr error;
+        std::thread producer;
+
+        std::size_t current = npos;
+        std::size_t pos = 0;
+        std::size_t start = 0;
+        std::string pending;
+        std::string record;
+        Mode mode = Mode::Unknown;
+        std::size_t depth = 0;
+        bool in_string = false;
+        bool escaped = false;
+    };
+
+    /** @brief Read all the records from a gzip compressed json or NDJSON file.
+     *
+     * This is a friendly function built on `GzipReader`.
+     *
+     * @param path The path of the file.
+     * @param format The layout of records in the file.
+     * @param BasicJsonType The json type used for parsing, `nlohmann::json` by default.
+     */
+    template <typename T, typename BasicJsonType = nlohmann::json>
+    std::vector<T> from_json_gz(const std::string &path, GzipFormat format = GzipFormat::Auto)
+    {
+        GzipReader<T, BasicJsonType> reader{path, format};
+        std::vector<T> records;
+        T t{};
+        while (reader.next(t))
+        {
+            records.push_back(std::move(t));
+        }
+        return records;
+    }
+
+} // namespace kie::json
+
+#endif
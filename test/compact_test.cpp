@@ -0,0 +1,148 @@
+#include <kie_json.hpp>
+#include <iostream>
+#include <gtest/gtest.h>
+
+struct CompactInner
+{
+  kie::json::Field<int, "i"> i;
+  kie::json::Field<std::vector<int>, "v"> v;
+};
+
+struct CompactA
+{
+  kie::json::Field<std::string, "name"> name;
+  bool b;
+  kie::json::Field<CompactInner, "inner"> inner;
+  kie::json::Field<std::vector<CompactInner>, "inner_vec"> inner_vec;
+  kie::json::Field<double, "d"> d;
+};
+
+struct CompactB
+{
+  kie::json::Field<std::string, "name"> name;
+  bool b;
+  kie::json::Field<CompactInner, "inner"> inner;
+  kie::json::Field<std::vector<CompactInner>, "inner_vec"> inner_vec;
+  kie::json::Field<int, "d"> d;
+};
+
+struct CompactNode
+{
+  kie::json::Field<int, "i"> i;
+  kie::json::Field<std::vector<CompactNode>, "c"> c;
+};
+
+struct CompactTree
+{
+  kie::json::Field<int, "i"> i;
+  kie::json::Field<std::vector<CompactTree>, "children"> children;
+};
+
+// Demonstrate some basic assertions.
+TEST(Compact, Fingerprint)
+{
+  using namespace kie::json;
+  static_assert(schema_fingerprint<CompactA> == schema_fingerprint<CompactA>);
+  static_assert(schema_fingerprint<CompactA> != schema_fingerprint<CompactB>);
+  static_assert(schema_fingerprint<CompactA> != schema_fingerprint<CompactInner>);
+  static_assert(schema_fingerprint<CompactNode> != schema_fingerprint<CompactTree>);
+}
+
+// Demonstrate some basic assertions.
+TEST(Compact, Serde)
+{
+  using namespace kie::json;
+
+  CompactA a{.name = std::string{"kie"}, .b = true, .inner = CompactInner{.i = 10, .v = std::vector{1, 2}}, .inner_vec = std::vector{CompactInner{.i = 1}}, .d = 1.5};
+  auto j = to_compact_json(a);
+  EXPECT_EQ(j.dump(), "[" + std::to_string(schema_fingerprint<CompactA>) + ",\"kie\",[10,[1,2]],[[1,[]]],1.5]");
+
+  auto b = from_compact_json<CompactA>(j.dump());
+  EXPECT_EQ(b.name.value, "kie");
+  EXPECT_EQ(b.b, false);
+  EXPECT_EQ(b.inner.value.i.value, 10);
+  EXPECT_EQ(b.inner.value.v.value, (std::vector{1, 2}));
+  ASSERT_EQ(b.inner_vec.value.size(), 1u);
+  EXPECT_EQ(b.inner_vec.value[0].i.value, 1);
+  EXPECT_EQ(b.d.value, 1.5);
+
+  EXPECT_THROW(from_compact_json<CompactB>(j.dump()), std::runtime_error);
+  EXPECT_THROW(from_compact_json<CompactA>(to_json(a).dump()), std::runtime_error);
+}
+
+// Demonstrate some basic assertions.
+TEST(Compact, MoreContainer)
+{
+  using namespace kie::json;
+
+  struct A
+  {
+    kie::json::Field<std::array<CompactInner, 2>, "inner_array"> inner_array;
+    kie::json::Field<std::map<std::string, CompactInner>, "inner_map"> inner_map;
+    kie::json::Field<std::deque<int>, "d"> d;
+  };
+
+  A a{.inner_array = std::array{CompactInner{.i = 1}, CompactInner{.i = 2}}, .inner_map = std::map<std::string, CompactInner>{{"x", CompactInner{.i = 3, .v = std::vector{4}}}}, .d = std::deque{5}};
+  auto b = from_compact_json<A>(to_compact_json(a).dump());
+  EXPECT_EQ(b.inner_array.value[1].i.value, 2);
+  EXPECT_EQ(b.inner_map.value["x"].i.value, 3);
+  EXPECT_EQ(b.inner_map.value["x"].v.value, std::vector{4});
+  EXPECT_EQ(b.d.value, std::deque{5});
+}
+
+// Demonstrate some basic assertions.
+TEST(Compact, Recursive)
+{
+  using namespace kie::json;
+
+  CompactNode a{.i = 1, .c = std::vector{CompactNode{.i = 2}, CompactNode{.i = 3, .c = std::vector{CompactNode{.i = 4}}}}};
+  auto j = to_compact_json(a);
+  EXPECT_EQ(j.dump(), "[" + std::to_string(schema_fingerprint<CompactNode>) + ",1,[[2,[]],[3,[[4,[]]]]]]");
+
+  auto b = from_compact_json<CompactNode>(j.dump());
+  ASSERT_EQ(b.c.value.size(), 2u);
+  ASSERT_EQ(b.c.value[1].c.value.size(), 1u);
+  EXPECT_EQ(b.c.value[1].c.value[0].i.value, 4);
+  EXPECT_EQ(to_json(b), to_json(a));
+}
+
+// Demonstrate some basic assertions.
+TEST(Compact, FieldCount)
+{
+  using namespace kie::json;
+
+  std::string fingerprint = std::to_string(schema_fingerprint<CompactA>);
+  EXPECT_NO_THROW(from_compact_json<CompactA>("[" + fingerprint + ",\"kie\",[10,[1,2]],[[1,[]]],1.5]"));
+  EXPECT_THROW(from_compact_json<CompactA>("[" + fingerprint + ",\"kie\",[10,[1,2]],[[1,[]]],1.5,1]"), std::runtime_error);
+  EXPECT_THROW(from_compact_json<CompactA>("[" + fingerprint + ",\"kie\",[10,[1,2]],[[1,[]]]]"), std::runtime_error);
+  EXPECT_THROW(from_compact_json<CompactA>("[" + fingerprint + ",\"kie\",[10,[1,2],3],[[1,[]]],1.5]"), std::runtime_error);
+  EXPECT_THROW(from_compact_json<CompactA>("[" + fingerprint + ",\"kie\",[10,[1,2]],[[1]],1.5]"), std::runtime_error);
+}
+
+// Demonstrate some basic assertions.
+TEST(Compact, Batch)
+{
+  using namespace kie::json;
+
+  std::vector<CompactInner> v{CompactInner{.i = 1, .v = std::vector{2}}, CompactInner{.i = 3}};
+  auto j = to_compact_json(v);
+  EXPECT_EQ(j.dump(), "[" + std::to_string(schema_fingerprint<std::vector<CompactInner>>) + ",[[1,[2]],[3,[]]]]");
+
+  auto b = from_compact_json<std::vector<CompactInner>>(j.dump());
+  ASSERT_EQ(b.size(), 2u);
+  EXPECT_EQ(b[0].v.value, std::vector{2});
+  EXPECT_EQ(b[1].i.value, 3);
+
+  std::map<std::string, CompactInner> m{{"x", CompactInner{.i = 4}}};
+  auto c = from_compact_json<std::map<std::string, CompactInner>>(to_compact_json(m).dump());
+  EXPECT_EQ(c["x"].i.value, 4);
+
+  EXPECT_THROW(from_compact_json<std::vector<CompactA>>(j.dump()), std::runtime_error);
+  EXPECT_THROW(from_compact_json<std::vector<CompactInner>>(j.dump().substr(0, j.dump().size() - 1) + ",1]"), std::runtime_error);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
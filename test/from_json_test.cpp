@@ -94,6 +94,18 @@ TEST(FromJson, StructPartial)
   EXPECT_EQ(c.inner.value.i.value, 20);
   EXPECT_EQ(c.inner.value.b, false);
   EXPECT_EQ(c.inner.value.inner.value.i, 0);
+
+  struct D
+  {
+    kie::json::Field<std::array<int, 2>, "a"> a = std::array{1, 2};
+    kie::json::Field<InnerRecognized, "inner_recognized"> inner = InnerRecognized{.i = 1, .b = true};
+  };
+
+  auto d = from_json<D>("{\"a\":null,\"inner_recognized\":{\"i\":5,\"inner\":null}}");
+  EXPECT_EQ(d.a.value, (std::array{0, 0}));
+  EXPECT_EQ(d.inner.value.i.value, 5);
+  EXPECT_EQ(d.inner.value.b, false);
+  EXPECT_THROW(from_json<D>("{\"a\":null,\"inner_recognized\":null}"), nlohmann::json::type_error);
 }
 
 // Demonstrate some basic assertions.
@@ -145,6 +157,118 @@ TEST(FromJson, StructComplex)
   EXPECT_EQ(a.inner_vec.value[2].v.value, (std::vector<int>{1, 2, 3, 4, 5}));
 }
 
+// Demonstrate some basic assertions.
+TEST(FromJson, FlatJson)
+{
+  using namespace kie::json;
+
+  struct Inner
+  {
+    kie::json::Field<int, "i"> i;
+    kie::json::Field<std::vector<int>, "v"> v;
+  };
+
+  struct A
+  {
+    kie::json::Field<std::vector<int>, "i"> i;
+    bool b;
+    kie::json::Field<Inner, "inner"> inner;
+    kie::json::Field<std::list<Inner>, "inner_list"> inner_list;
+  };
+
+  auto a = from_json<A, flat_json>("{\"inner_list\":[{\"v\":[1],\"i\":10}],\"inner\":{\"v\":[1,2],\"i\":20},\"i\":[1,2,3]}");
+  EXPECT_EQ(a.i.value, (std::vector<int>{1, 2, 3}));
+  EXPECT_EQ(a.inner.value.i.value, 20);
+  EXPECT_EQ(a.inner.value.v.value, (std::vector<int>{1, 2}));
+  EXPECT_EQ(a.inner_list.value.front().i.value, 10);
+  EXPECT_EQ(a.inner_list.value.front().v.value, std::vector<int>{1});
+
+  EXPECT_EQ((from_json<std::vector<int>, flat_json>("[1,2,3]")), (std::vector{1, 2, 3}));
+}
+
+// Demonstrate some basic assertions.
+TEST(FromJson, Parallel)
+{
+  using namespace kie::json;
+
+  struct Inner
+  {
+    kie::json::Field<int, "i"> i;
+    kie::json::Field<std::string, "s"> s;
+    kie::json::Field<std::vector<int>, "v"> v;
+  };
+
+  std::string str = "[";
+  for (int i = 0; i < 1000; i++)
+  {
+    str += (i == 0 ? "" : " ,\n");
+    str += "{\"i\":" + std::to_string(i) + ",\"s\":\"a,]}\\\"[{\",\"v\":[" + std::to_string(i) + ",1]}";
+  }
+  str += "]";
+
+  auto a = from_json_parallel<std::vector<Inner>>(str, 4);
+  ASSERT_EQ(a.size(), 1000u);
+  for (int i = 0; i < 1000; i++)
+  {
+    EXPECT_EQ(a[i].i.value, i);
+    EXPECT_EQ(a[i].s.value, "a,]}\"[{");
+    EXPECT_EQ(a[i].v.value, (std::vector{i, 1}));
+  }
+
+  EXPECT_EQ(from_json_parallel<std::vector<int>>(" [1, 2,3] ", 8), (std::vector{1, 2, 3}));
+  EXPECT_EQ(from_json_parallel<std::vector<int>>("[ ]"), std::vector<int>{});
+  EXPECT_EQ(from_json_parallel<std::vector<int>>("null"), std::vector<int>{});
+  EXPECT_EQ((from_json_parallel<std::vector<std::vector<int>>, flat_json>("[[1],[2,3]]", 2)), (std::vector<std::vector<int>>{{1}, {2, 3}}));
+  EXPECT_THROW(from_json_parallel<std::vector<int>>("[1,]"), nlohmann::json::parse_error);
+  EXPECT_THROW(from_json_parallel<std::vector<int>>("[1}"), nlohmann::json::parse_error);
+  EXPECT_THROW(from_json_parallel<std::vector<int>>("[1,2,{]", 2), nlohmann::json::parse_error);
+  EXPECT_THROW(from_json_parallel<std::vector<int>>("[1,2,x]", 2), nlohmann::json::parse_error);
+}
+
+// Demonstrate some basic assertions.
+TEST(FromJson, MoreContainer)
+{
+  using namespace kie::json;
+
+  EXPECT_EQ((from_json<std::array<int, 3>>("[1,2,3]")), (std::array{1, 2, 3}));
+  EXPECT_EQ((from_json<std::array<int, 3>>("null")), (std::array{0, 0, 0}));
+  EXPECT_THROW((from_json<std::array<int, 3>>("[1,2]")), std::runtime_error);
+  EXPECT_EQ(from_json<std::deque<int>>("[1,2,3]"), (std::deque{1, 2, 3}));
+  EXPECT_EQ(from_json<std::vector<bool>>("[true,false]"), (std::vector{true, false}));
+  EXPECT_EQ((from_json<std::map<std::string, int>>("{\"b\":2,\"a\":1}")), (std::map<std::string, int>{{"a", 1}, {"b", 2}}));
+  EXPECT_EQ((from_json<std::unordered_map<std::string, int>>("{\"b\":2,\"a\":1}")), (std::unordered_map<std::string, int>{{"a", 1}, {"b", 2}}));
+  EXPECT_EQ((from_json<std::map<std::string, int>>("null")), (std::map<std::string, int>{}));
+
+  struct Inner
+  {
+    kie::json::Field<int, "i"> i;
+    kie::json::Field<std::array<std::string, 2>, "s"> s;
+  };
+
+  struct A
+  {
+    kie::json::Field<std::array<Inner, 2>, "inner_array"> inner_array;
+    kie::json::Field<std::deque<Inner>, "inner_deque"> inner_deque;
+    kie::json::Field<std::unordered_map<std::string, Inner>, "inner_map"> inner_map;
+    kie::json::Field<std::map<std::string, std::vector<int>>, "vec_map"> vec_map;
+  };
+
+  auto a = from_json<A>("{\"inner_array\":[{\"i\":1,\"s\":[\"a\",\"b\"]},{\"i\":2,\"s\":null}],\"inner_deque\":[{\"i\":3,\"s\":null}],"
+                        "\"inner_map\":{\"x\":{\"i\":4,\"s\":[\"c\",\"d\"]}},\"vec_map\":{\"y\":[1,2]}}");
+  EXPECT_EQ(a.inner_array.value[0].i.value, 1);
+  EXPECT_EQ(a.inner_array.value[0].s.value, (std::array<std::string, 2>{"a", "b"}));
+  EXPECT_EQ(a.inner_array.value[1].i.value, 2);
+  EXPECT_EQ(a.inner_array.value[1].s.value, (std::array<std::string, 2>{}));
+  ASSERT_EQ(a.inner_deque.value.size(), 1u);
+  EXPECT_EQ(a.inner_deque.value[0].i.value, 3);
+  ASSERT_EQ(a.inner_map.value.count("x"), 1u);
+  EXPECT_EQ(a.inner_map.value["x"].i.value, 4);
+  EXPECT_EQ(a.inner_map.value["x"].s.value, (std::array<std::string, 2>{"c", "d"}));
+  EXPECT_EQ(a.vec_map.value["y"], (std::vector{1, 2}));
+
+  EXPECT_EQ(from_json<A>(to_json(a).dump()).inner_map.value["x"].s.value, a.inner_map.value["x"].s.value);
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,165 @@
+#include <kie_json_gzip.hpp>
+#include <iostream>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <gtest/gtest.h>
+
+struct Record
+{
+  kie::json::Field<int, "i"> i;
+  kie::json::Field<std::string, "s"> s;
+};
+
+static std::string write_gz(const std::string &name, const std::string &content)
+{
+  std::string path = testing::TempDir() + name;
+  gzFile file = gzopen(path.c_str(), "wb");
+  gzwrite(file, content.data(), static_cast<unsigned>(content.size()));
+  gzclose(file);
+  return path;
+}
+
+// Demonstrate some basic assertions.
+TEST(Gzip, NDJson)
+{
+  using namespace kie::json;
+
+  std::string content;
+  for (int i = 0; i < 100; i++)
+  {
+    content += "{\"i\":" + std::to_string(i) + ",\"s\":\"a\\n\\\"}{\"}\n";
+  }
+  content += "\n{\"i\":100,\"s\":\"end\"}";
+  auto path = write_gz("kie_json_test.ndjson.gz", content);
+
+  GzipReader<Record> reader{path, GzipFormat::Auto, 7, 2};
+  Record r;
+  int n = 0;
+  while (reader.next(r))
+  {
+    EXPECT_EQ(r.i.value, n);
+    EXPECT_EQ(r.s.value, n == 100 ? "end" : "a\n\"}{");
+    n++;
+  }
+  EXPECT_EQ(n, 101);
+  std::remove(path.c_str());
+}
+
+// Demonstrate some basic assertions.
+TEST(Gzip, Array)
+{
+  using namespace kie::json;
+
+  std::string content = " [";
+  for (int i = 0; i < 100; i++)
+  {
+    content += (i == 0 ? "" : ",\n");
+    content += "{\"i\":" + std::to_string(i) + ",\"s\":\"[,]\"}";
+  }
+  content += "]\n";
+  auto path = write_gz("kie_json_test.json.gz", content);
+
+  auto records = from_json_gz<Record>(path);
+  ASSERT_EQ(records.size(), 100u);
+  for (int i = 0; i < 100; i++)
+  {
+    EXPECT_EQ(records[i].i.value, i);
+    EXPECT_EQ(records[i].s.value, "[,]");
+  }
+
+  GzipReader<Record> reader{path, GzipFormat::Array, 5, 3};
+  Record r;
+  int n = 0;
+  while (reader.next(r))
+  {
+    n++;
+  }
+  EXPECT_EQ(n, 100);
+  std::remove(path.c_str());
+
+  EXPECT_THROW(GzipReader<Record>{"/not/exist.json.gz"}, std::runtime_error);
+}
+
+// Demonstrate some basic assertions.
+TEST(Gzip, Truncated)
+{
+  using namespace kie::json;
+
+  std::string content = "[";
+  for (int i = 0; i < 50000; i++)
+  {
+    content += (i == 0 ? "" : ",");
+    content += "{\"i\":" + std::to_string(i) + ",\"s\":\"s\"}";
+  }
+  content += "]";
+  auto path = write_gz("kie_json_test_full.json.gz", content);
+
+  std::ifstream in{path, std::ios::binary};
+  std::string bytes{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+  std::string truncated = testing::TempDir() + "kie_json_test_truncated.json.gz";
+  std::ofstream{truncated, std::ios::binary}.write(bytes.data(), static_cast<std::streamsize>(bytes.size() / 2));
+
+  EXPECT_EQ(from_json_gz<Record>(path).size(), 50000u);
+  EXPECT_THROW(from_json_gz<Record>(truncated), std::runtime_error);
+  std::remove(path.c_str());
+  std::remove(truncated.c_str());
+}
+
+// Demonstrate some basic assertions.
+TEST(Gzip, Malformed)
+{
+  using namespace kie::json;
+
+  auto path = write_gz("kie_json_test_trailing.json.gz", "[{\"i\":1,\"s\":\"a\"}] {\"i\":2,\"s\":\"b\"} garbage");
+  EXPECT_THROW(from_json_gz<Record>(path), std::runtime_error);
+  std::remove(path.c_str());
+
+  path = write_gz("kie_json_test_whitespace.json.gz", "[{\"i\":1,\"s\":\"a\"}] \n\t ");
+  EXPECT_EQ(from_json_gz<Record>(path).size(), 1u);
+  std::remove(path.c_str());
+
+  path = write_gz("kie_json_test_unclosed.json.gz", "[{\"i\":1,\"s\":\"a\"},{\"i\":2,\"s\":\"b\"}");
+  EXPECT_THROW(from_json_gz<Record>(path), std::runtime_error);
+  std::remove(path.c_str());
+
+  path = write_gz("kie_json_test_unterminated.ndjson.gz", "{\"i\":1,\"s\":\"a\"}\n{\"i\":2,\"s\":\"b");
+  EXPECT_THROW(from_json_gz<Record>(path), std::runtime_error);
+  std::remove(path.c_str());
+}
+
+// Demonstrate some basic assertions.
+TEST(Gzip, NDJsonOfArrays)
+{
+  using namespace kie::json;
+
+  std::string content = "[1,2]\n[3]\n[4,5,6]\n";
+  std::vector<std::vector<int>> expected{{1, 2}, {3}, {4, 5, 6}};
+
+  auto path = write_gz("kie_json_test_arrays.ndjson.gz", content);
+  EXPECT_EQ(from_json_gz<std::vector<int>>(path), expected);
+  std::remove(path.c_str());
+
+  path = write_gz("kie_json_test_arrays.gz", content);
+  EXPECT_EQ(from_json_gz<std::vector<int>>(path, GzipFormat::Lines), expected);
+  GzipReader<std::vector<int>> reader{path, GzipFormat::Lines, 3, 2};
+  std::vector<int> v;
+  std::size_t n = 0;
+  while (reader.next(v))
+  {
+    EXPECT_EQ(v, expected[n++]);
+  }
+  EXPECT_EQ(n, 3u);
+  std::remove(path.c_str());
+
+  path = write_gz("kie_json_test_not_array.json.gz", "{\"i\":1,\"s\":\"a\"}\n");
+  EXPECT_THROW(from_json_gz<Record>(path, GzipFormat::Array), std::runtime_error);
+  EXPECT_EQ(from_json_gz<Record>(path).size(), 1u);
+  std::remove(path.c_str());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,87 @@
+#include <kie_json.hpp>
+#include <iostream>
+#include <thread>
+#include <gtest/gtest.h>
+
+// Demonstrate some basic assertions.
+TEST(Intern, Pool)
+{
+  using namespace kie::json;
+
+  InternPool pool;
+  auto a = pool.intern("hello");
+  auto b = pool.intern(std::string{"hello"});
+  EXPECT_EQ(a, "hello");
+  EXPECT_EQ(a.data(), b.data());
+  EXPECT_NE(a.data(), pool.intern("world").data());
+  EXPECT_EQ(pool.intern("").size(), 0u);
+  EXPECT_EQ(pool.size(), 2u);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++)
+  {
+    threads.emplace_back([&pool]
+                         {
+      for(int j = 0; j < 1000; j++){
+        pool.intern(std::to_string(j % 100));
+      } });
+  }
+  for (auto &t : threads)
+  {
+    t.join();
+  }
+  EXPECT_EQ(pool.size(), 102u);
+}
+
+// Demonstrate some basic assertions.
+TEST(Intern, Serde)
+{
+  using namespace kie::json;
+
+  struct A
+  {
+    kie::json::Field<InternedString, "status"> status;
+    kie::json::Field<std::vector<InternedString>, "hosts"> hosts;
+  };
+
+  auto a = from_json<std::vector<A>>("[{\"status\":\"ok\",\"hosts\":[\"a\",\"b\"]},{\"status\":\"ok\",\"hosts\":[\"b\"]},{\"status\":null,\"hosts\":null}]");
+  ASSERT_EQ(a.size(), 3u);
+  EXPECT_EQ(a[0].status.value, "ok");
+  EXPECT_EQ(a[0].status.value, a[1].status.value);
+  EXPECT_EQ(a[0].status.value.view().data(), a[1].status.value.view().data());
+  EXPECT_EQ(a[0].hosts.value[1], a[1].hosts.value[0]);
+  EXPECT_EQ(a[2].status.value, InternedString{});
+
+  EXPECT_EQ(to_json(a[0]).dump(), "{\"hosts\":[\"a\",\"b\"],\"status\":\"ok\"}");
+
+  A b = a[1];
+  b.status = InternedString{"failed"};
+  EXPECT_EQ(diff(a[1], b).dump(), "{\"status\":\"failed\"}");
+  apply_patch(a[1], diff(a[1], b).dump());
+  EXPECT_EQ(a[1].status.value, b.status.value);
+}
+
+// Demonstrate some basic assertions.
+TEST(Intern, TwoPools)
+{
+  using namespace kie::json;
+
+  struct A
+  {
+    kie::json::Field<InternedString, "s"> s;
+  };
+
+  InternPool pool;
+  InternedString a{"ok"};
+  InternedString b{"ok", pool};
+  EXPECT_NE(a.view().data(), b.view().data());
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, (InternedString{"failed", pool}));
+  EXPECT_EQ(diff(A{.s = a}, A{.s = b}).dump(), "{}");
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,173 @@
+#include <kie_json.hpp>
+#include <iostream>
+#include <gtest/gtest.h>
+
+// Demonstrate some basic assertions.
+TEST(Patch, Diff)
+{
+  using namespace kie::json;
+
+  struct Inner
+  {
+    kie::json::Field<int, "i"> i;
+    kie::json::Field<std::vector<int>, "v"> v;
+  };
+
+  struct A
+  {
+    kie::json::Field<int, "i"> i;
+    bool b;
+    kie::json::Field<std::string, "s"> s;
+    kie::json::Field<Inner, "inner"> inner;
+    kie::json::Field<std::vector<Inner>, "inner_vec"> inner_vec;
+  };
+
+  A a{.i = 1, .s = std::string{"hello"}, .inner = Inner{.i = 10, .v = std::vector{1, 2, 3}}};
+  A b = a;
+  EXPECT_EQ(diff(a, b).dump(), "{}");
+
+  b.b = true;
+  EXPECT_EQ(diff(a, b).dump(), "{}");
+
+  b.i = 2;
+  b.inner.value.v = std::vector{1, 2};
+  EXPECT_EQ(diff(a, b).dump(), "{\"i\":2,\"inner\":{\"v\":[1,2]}}");
+
+  b = a;
+  b.s = std::string{"world"};
+  b.inner.value.v = std::vector<int>{};
+  b.inner_vec = std::vector{Inner{.i = 1}};
+  EXPECT_EQ(diff(a, b).dump(), "{\"inner\":{\"v\":[]},\"inner_vec\":[{\"i\":1,\"v\":null}],\"s\":\"world\"}");
+}
+
+// Demonstrate some basic assertions.
+TEST(Patch, Apply)
+{
+  using namespace kie::json;
+
+  struct Inner
+  {
+    kie::json::Field<int, "i"> i;
+    kie::json::Field<std::vector<int>, "v"> v;
+  };
+
+  struct A
+  {
+    kie::json::Field<int, "i"> i;
+    bool b;
+    kie::json::Field<std::string, "s"> s;
+    kie::json::Field<Inner, "inner"> inner;
+    kie::json::Field<std::vector<Inner>, "inner_vec"> inner_vec;
+  };
+
+  A a{.i = 1, .b = true, .s = std::string{"hello"}, .inner = Inner{.i = 10, .v = std::vector{1, 2, 3}}};
+  apply_patch(a, "{\"i\":2,\"inner\":{\"v\":null},\"inner_vec\":[{\"i\":1,\"v\":[4]}]}");
+  EXPECT_EQ(a.i.value, 2);
+  EXPECT_EQ(a.b, true);
+  EXPECT_EQ(a.s.value, "hello");
+  EXPECT_EQ(a.inner.value.i.value, 10);
+  EXPECT_EQ(a.inner.value.v.value, std::vector<int>{});
+  EXPECT_EQ(a.inner_vec.value.size(), 1u);
+  EXPECT_EQ(a.inner_vec.value[0].i.value, 1);
+  EXPECT_EQ(a.inner_vec.value[0].v.value, std::vector{4});
+
+  A b = a;
+  b.s = std::string{"world"};
+  b.inner.value.i = 20;
+  b.inner_vec = std::vector<Inner>{};
+  apply_patch(a, diff(a, b).dump());
+  EXPECT_EQ(to_json(a), to_json(b));
+
+  // a non-object patch would replace the whole instance, which can't be done in place
+  EXPECT_THROW(apply_patch(a, "[1,2]"), std::runtime_error);
+  EXPECT_THROW(apply_patch(a, "null"), std::runtime_error);
+  EXPECT_EQ(to_json(a), to_json(b));
+}
+
+// Demonstrate some basic assertions.
+TEST(Patch, MergePatch)
+{
+  using namespace kie::json;
+
+  struct Inner
+  {
+    kie::json::Field<int, "i"> i;
+    kie::json::Field<std::vector<int>, "v"> v;
+  };
+
+  struct A
+  {
+    kie::json::Field<int, "i"> i;
+    kie::json::Field<Inner, "inner"> inner;
+    kie::json::Field<std::list<int>, "l"> l;
+  };
+
+  A a{.i = 1, .inner = Inner{.i = 1, .v = std::vector{1, 2}}, .l = std::list{1}};
+  A b = a;
+  b.inner.value.v = std::vector<int>{};
+  b.l = std::list<int>{};
+
+  // the patch must also be valid for any standard merge patch implementation
+  auto j = to_json(a);
+  j.merge_patch(diff(a, b));
+  auto c = from_json<A>(j.dump());
+  EXPECT_EQ(c.i.value, 1);
+  EXPECT_EQ(c.inner.value.i.value, 1);
+  EXPECT_EQ(c.inner.value.v.value, std::vector<int>{});
+  EXPECT_EQ(c.l.value, std::list<int>{});
+
+  apply_patch(a, diff(a, b).dump());
+  EXPECT_EQ(to_json(a), to_json(b));
+}
+
+// Demonstrate some basic assertions.
+TEST(Patch, Map)
+{
+  using namespace kie::json;
+
+  struct Inner
+  {
+    kie::json::Field<int, "i"> i;
+    kie::json::Field<std::vector<int>, "v"> v;
+  };
+
+  struct A
+  {
+    kie::json::Field<std::map<std::string, int>, "m"> m;
+    kie::json::Field<std::map<std::string, Inner>, "inner_map"> inner_map;
+  };
+
+  A a{.m = std::map<std::string, int>{{"x", 1}, {"y", 2}},
+      .inner_map = std::map<std::string, Inner>{{"p", Inner{.i = 1, .v = std::vector{1}}}, {"q", Inner{.i = 2}}}};
+  A b = a;
+  b.m.value.erase("y");
+  b.inner_map.value["p"].i = 10;
+  b.inner_map.value.erase("q");
+  b.inner_map.value["r"] = Inner{.i = 3};
+  EXPECT_EQ(diff<flat_json>(a, b).dump(), "{\"m\":{\"y\":null},\"inner_map\":{\"q\":null,\"p\":{\"i\":10},\"r\":{\"i\":3,\"v\":[]}}}");
+
+  // removed keys must be deleted by any standard merge patch implementation
+  auto j = to_json(a);
+  j.merge_patch(diff(a, b));
+  auto c = from_json<A>(j.dump());
+  EXPECT_EQ(to_json(c), to_json(b));
+  EXPECT_EQ(c.m.value, (std::map<std::string, int>{{"x", 1}}));
+  EXPECT_EQ(c.inner_map.value.size(), 2u);
+  EXPECT_EQ(c.inner_map.value["r"].i.value, 3);
+
+  apply_patch(a, diff(a, b).dump());
+  EXPECT_EQ(to_json(a), to_json(b));
+
+  b.m = std::map<std::string, int>{};
+  j = to_json(a);
+  j.merge_patch(diff(a, b));
+  EXPECT_EQ(from_json<A>(j.dump()).m.value, (std::map<std::string, int>{}));
+  apply_patch(a, diff(a, b).dump());
+  EXPECT_EQ(a.m.value, (std::map<std::string, int>{}));
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -134,6 +134,68 @@ TEST(ToJson, StructComplex)
   EXPECT_EQ(to_json(A{}).dump(), "{\"i\":[1,2,3,4,5],\"inner\":{\"i\":10,\"v\":[1,2,3,4,5]},\"inner_array\":[{\"i\":10,\"v\":[1,2,3,4,5]},{\"i\":10,\"v\":[1,2,3,4,5]},{\"i\":10,\"v\":[1,2,3,4,5]}]}");
 }
 
+// Demonstrate some basic assertions.
+TEST(ToJson, FlatJson)
+{
+  using namespace kie::json;
+
+  struct Inner
+  {
+    kie::json::Field<int, "z"> z = 10;
+    kie::json::Field<std::vector<int>, "a"> a = std::vector{1, 2, 3};
+  };
+
+  struct A
+  {
+    kie::json::Field<std::string, "name"> name = std::string{"kie"};
+    bool b;
+    kie::json::Field<Inner, "inner"> inner;
+    kie::json::Field<std::vector<Inner>, "inner_vec"> inner_vec = std::vector{Inner{}};
+  };
+
+  EXPECT_EQ(to_json<flat_json>(A{}).dump(), "{\"name\":\"kie\",\"inner\":{\"z\":10,\"a\":[1,2,3]},\"inner_vec\":[{\"z\":10,\"a\":[1,2,3]}]}");
+  EXPECT_EQ(to_json<nlohmann::ordered_json>(std::vector{1, 2}).dump(), "[1,2]");
+  EXPECT_EQ(to_json<flat_json>(std::string{"hello"}).dump(), "null");
+}
+
+// Demonstrate some basic assertions.
+TEST(ToJson, MoreContainer)
+{
+  using namespace kie::json;
+  EXPECT_EQ(to_json(std::deque{1, 2, 3}).dump(), "[1,2,3]");
+  EXPECT_EQ(to_json(std::deque<int>{}).dump(), "null");
+  EXPECT_EQ(to_json(std::map<std::string, int>{{"b", 2}, {"a", 1}}).dump(), "{\"a\":1,\"b\":2}");
+  EXPECT_EQ(to_json<flat_json>(std::map<std::string, int>{{"b", 2}, {"a", 1}}).dump(), "{\"a\":1,\"b\":2}");
+  EXPECT_EQ(to_json(std::unordered_map<std::string, int>{}).dump(), "null");
+
+  struct Inner
+  {
+    kie::json::Field<int, "i"> i = 10;
+  };
+
+  struct A
+  {
+    kie::json::Field<std::map<std::string, Inner>, "inner_map"> inner_map = std::map<std::string, Inner>{{"x", Inner{}}};
+    kie::json::Field<std::deque<Inner>, "inner_deque"> inner_deque = std::deque{Inner{}};
+  };
+
+  EXPECT_EQ(to_json(A{}).dump(), "{\"inner_deque\":[{\"i\":10}],\"inner_map\":{\"x\":{\"i\":10}}}");
+}
+
+// Demonstrate some basic assertions.
+TEST(ToJson, EncodeOnly)
+{
+  using namespace kie::json;
+
+  // const char * can't be decoded, which must not matter when only to_json is used
+  struct A
+  {
+    kie::json::Field<const char *, "c"> c;
+  };
+
+  EXPECT_EQ(to_json(A{.c = "hello"}).dump(), "{\"c\":\"hello\"}");
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);